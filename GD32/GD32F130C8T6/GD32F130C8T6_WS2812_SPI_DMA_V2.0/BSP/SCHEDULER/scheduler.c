@@ -0,0 +1,121 @@
+#include "gd32f1x0.h"
+#include <stdio.h>
+#include "scheduler.h"
+#include "systick.h"
+
+// 协作式调度：任务在主循环里轮流运行，不能抢占，每一步都要尽快返回
+static scheduler_task_t tasks[SCHEDULER_MAX_TASKS];
+static uint8_t task_num;
+
+// 负载统计：统计窗口起点和窗口内任务运行的总周期数
+static uint32_t stats_start_ms;
+static uint64_t busy_cycles;
+
+/**
+ * @brief 注册任务，注册后立即到期运行一次
+ * @param name 任务名，用于统计输出
+ * @param step 单步函数
+ * @return 任务编号，表满时返回 -1
+ */
+int8_t scheduler_add(const char *name, scheduler_step_t step)
+{
+    if (task_num >= SCHEDULER_MAX_TASKS || step == NULL)
+        return -1;
+
+    tasks[task_num].name = name;
+    tasks[task_num].step = step;
+    tasks[task_num].next_ms = systick_ms_get();
+    if (task_num == 0)
+        scheduler_stats_reset();
+    return (int8_t)task_num++;
+}
+
+/**
+ * @brief 调度主循环，不返回
+ *        运行所有到期任务；没有到期任务时 WFI 休眠，
+ *        SysTick（1 ms）或其他中断唤醒后重新检查
+ */
+void scheduler_run(void)
+{
+    cycle_counter_init();
+    while (1)
+    {
+        uint8_t ran = 0;
+
+        for (uint8_t i = 0; i < task_num; i++)
+        {
+            scheduler_task_t *t = &tasks[i];
+            uint32_t now = systick_ms_get();
+
+            // 有符号差值比较，tick 回绕后仍然正确
+            if ((int32_t)(now - t->next_ms) < 0)
+                continue;
+
+            uint32_t start = cycle_counter_get();
+            uint32_t delay = t->step(now);
+            uint32_t cycles = cycle_counter_get() - start;
+
+            // 以本次计划时刻为基准推进，避免执行时间累积成漂移；落后太多则从当前时刻重新计
+            t->next_ms += delay;
+            if ((int32_t)(now - t->next_ms) > 0)
+                t->next_ms = now;
+
+            t->runs++;
+            t->cycles += cycles;
+            if (cycles > t->max_cycles)
+                t->max_cycles = cycles;
+            busy_cycles += cycles;
+            ran = 1;
+        }
+
+        if (!ran)
+            __WFI();
+    }
+}
+
+/**
+ * @brief 统计窗口内 CPU 占用率
+ * @return 千分比，0 表示几乎一直在休眠
+ */
+uint16_t scheduler_load_permille(void)
+{
+    uint64_t total = (uint64_t)(systick_ms_get() - stats_start_ms) * (SystemCoreClock / 1000U);
+
+    if (total == 0)
+        return 0;
+    return (uint16_t)(busy_cycles * 1000U / total);
+}
+
+const scheduler_task_t *scheduler_task_get(uint8_t id)
+{
+    return (id < task_num) ? &tasks[id] : NULL;
+}
+
+// 清零各任务统计并开始新的统计窗口
+void scheduler_stats_reset(void)
+{
+    for (uint8_t i = 0; i < task_num; i++)
+    {
+        tasks[i].runs = 0;
+        tasks[i].cycles = 0;
+        tasks[i].max_cycles = 0;
+    }
+    busy_cycles = 0;
+    stats_start_ms = systick_ms_get();
+}
+
+// 串口打印各任务统计，周期数换算成微秒
+void scheduler_report(void)
+{
+    uint32_t mhz = SystemCoreClock / 1000000U;
+
+    uint16_t load = scheduler_load_permille();
+
+    printf("[sched] load %u.%u%%\n", load / 10U, load % 10U);
+    for (uint8_t i = 0; i < task_num; i++)
+    {
+        const scheduler_task_t *t = &tasks[i];
+        printf("[sched] %-10s runs %lu avg %lu us max %lu us\n", t->name, (unsigned long)t->runs,
+               (unsigned long)(t->runs ? (uint32_t)(t->cycles / t->runs) / mhz : 0), (unsigned long)(t->max_cycles / mhz));
+    }
+}
@@ -0,0 +1,28 @@
+#ifndef __SCHEDULER_H
+#define __SCHEDULER_H
+
+#include <stdint.h>
+
+#define SCHEDULER_MAX_TASKS 8
+
+// 任务单步函数：做完一小步就返回，返回值为距下次运行的毫秒数
+typedef uint32_t (*scheduler_step_t)(uint32_t now_ms);
+
+typedef struct
+{
+    const char *name;
+    scheduler_step_t step;
+    uint32_t next_ms;    // 下次运行时刻
+    uint32_t runs;       // 运行次数
+    uint64_t cycles;     // 累计运行周期数
+    uint32_t max_cycles; // 单次运行最长周期数
+} scheduler_task_t;
+
+int8_t scheduler_add(const char *name, scheduler_step_t step);
+void scheduler_run(void);
+uint16_t scheduler_load_permille(void);
+const scheduler_task_t *scheduler_task_get(uint8_t id);
+void scheduler_stats_reset(void);
+void scheduler_report(void);
+
+#endif
@@ -2,6 +2,207 @@
 #include <stdio.h>
 #include "usart.h"
 
+#if USART_TX_DMA
+#if (USART_TX_BUF_SIZE & (USART_TX_BUF_SIZE - 1)) != 0
+#error "USART_TX_BUF_SIZE 必须是 2 的幂"
+#endif
+
+// 单生产者（主循环里的 printf）单消费者（DMA）环形缓冲：head 只由 fputc 推进，tail 只由 DMA 完成中断推进，
+// 下标自由增长、取模访问，head - tail 即缓冲区中的字节数
+static uint8_t tx_buf[USART_TX_BUF_SIZE];
+static volatile uint16_t tx_head;
+static volatile uint16_t tx_tail;
+static volatile uint16_t tx_dma_len; // 正在发送的字节数，0 表示 DMA 空闲
+static uint8_t tx_policy = USART_TX_POLICY;
+static volatile uint32_t tx_dropped;
+
+// 从 tail 起发送一段连续数据，回绕处截断，剩下的在完成中断里接着发
+static void uart_tx_dma_start(void)
+{
+    uint16_t pos = tx_tail & (USART_TX_BUF_SIZE - 1U);
+    uint16_t len = (uint16_t)(tx_head - tx_tail);
+
+    if (len > USART_TX_BUF_SIZE - pos)
+        len = USART_TX_BUF_SIZE - pos;
+    tx_dma_len = len;
+    dma_channel_disable(DMA_CH3);
+    dma_memory_address_config(DMA_CH3, (uint32_t)&tx_buf[pos]);
+    dma_transfer_number_config(DMA_CH3, len);
+    dma_channel_enable(DMA_CH3);
+}
+
+static void uart_tx_dma_init(void)
+{
+    dma_parameter_struct dma_init_struct;
+
+    // USART0_TX 默认在 DMA_CH1，与 WS2812 定时器输出冲突，重映射到 DMA_CH3
+    rcu_periph_clock_enable(RCU_CFGCMP);
+    rcu_periph_clock_enable(RCU_DMA);
+    syscfg_dma_remap_enable(SYSCFG_DMA_REMAP_USART0TX);
+
+    dma_deinit(DMA_CH3);
+    dma_init_struct.periph_addr = (uint32_t)(&USART_TDATA(USART0));
+    dma_init_struct.memory_addr = 0;
+    dma_init_struct.direction = DMA_MEMORY_TO_PERIPHERAL;
+    dma_init_struct.periph_width = DMA_PERIPHERAL_WIDTH_8BIT;
+    dma_init_struct.memory_width = DMA_MEMORY_WIDTH_8BIT;
+    dma_init_struct.periph_inc = DMA_PERIPH_INCREASE_DISABLE;
+    dma_init_struct.memory_inc = DMA_MEMORY_INCREASE_ENABLE;
+    dma_init_struct.number = 0;
+    dma_init_struct.priority = DMA_PRIORITY_LOW; // 让 WS2812 的 DMA 优先
+    dma_init(DMA_CH3, &dma_init_struct);
+    dma_circulation_disable(DMA_CH3);
+    dma_memory_to_memory_disable(DMA_CH3);
+
+    dma_interrupt_enable(DMA_CH3, DMA_INT_FTF);
+    nvic_irq_enable(DMA_Channel3_4_IRQn, 2, 0);
+    usart_dma_transmit_config(USART0, USART_TRANSMIT_DMA_ENABLE);
+}
+
+// DMA_CH3 传输完成中断里调用：释放已发出的一段，还有数据就接着发
+void uart_tx_dma_isr(void)
+{
+    tx_tail += tx_dma_len;
+    if (tx_head != tx_tail)
+        uart_tx_dma_start();
+    else
+        tx_dma_len = 0;
+}
+
+// 切换缓冲区满时的处理方式，USART_TX_DROP / USART_TX_BLOCK
+void uart_tx_policy_set(uint8_t policy) { tx_policy = policy; }
+
+// 因缓冲区满被丢弃的字节数
+uint32_t uart_tx_dropped(void) { return tx_dropped; }
+
+// 等待缓冲区中的数据全部发出，例如复位或进入低功耗前
+void uart_flush(void)
+{
+    while (tx_head != tx_tail)
+        ;
+    while (RESET == usart_flag_get(USART0, USART_FLAG_TC))
+        ;
+}
+#endif
+
+#if USART_RX_DMA
+#if (USART_RX_BUF_SIZE & (USART_RX_BUF_SIZE - 1)) != 0
+#error "USART_RX_BUF_SIZE 必须是 2 的幂"
+#endif
+
+// DMA 循环写 rx_buf；rx_head 为累计收到的字节数，只在中断里按 DMA 剩余计数推进，
+// rx_tail 为累计读走的字节数，只由主循环推进；两者之差超过缓冲区大小说明数据已被覆盖
+static uint8_t rx_buf[USART_RX_BUF_SIZE];
+static volatile uint32_t rx_head;
+static uint32_t rx_tail;
+static uint16_t rx_dma_pos; // 上次中断时 DMA 的写入位置
+static uint32_t rx_overrun;
+
+static void uart_rx_dma_init(void)
+{
+    dma_parameter_struct dma_init_struct;
+
+    // USART0_RX 默认在 DMA_CH2，与 SPI0_TX / GPIO 并行冲突，重映射到 DMA_CH4
+    rcu_periph_clock_enable(RCU_CFGCMP);
+    rcu_periph_clock_enable(RCU_DMA);
+    syscfg_dma_remap_enable(SYSCFG_DMA_REMAP_USART0RX);
+
+    dma_deinit(DMA_CH4);
+    dma_init_struct.periph_addr = (uint32_t)(&USART_RDATA(USART0));
+    dma_init_struct.memory_addr = (uint32_t)rx_buf;
+    dma_init_struct.direction = DMA_PERIPHERAL_TO_MEMORY;
+    dma_init_struct.periph_width = DMA_PERIPHERAL_WIDTH_8BIT;
+    dma_init_struct.memory_width = DMA_MEMORY_WIDTH_8BIT;
+    dma_init_struct.periph_inc = DMA_PERIPH_INCREASE_DISABLE;
+    dma_init_struct.memory_inc = DMA_MEMORY_INCREASE_ENABLE;
+    dma_init_struct.number = USART_RX_BUF_SIZE;
+    dma_init_struct.priority = DMA_PRIORITY_MEDIUM;
+    dma_init(DMA_CH4, &dma_init_struct);
+    dma_circulation_enable(DMA_CH4);
+    dma_memory_to_memory_disable(DMA_CH4);
+
+    rx_head = 0;
+    rx_tail = 0;
+    rx_dma_pos = 0;
+    dma_interrupt_enable(DMA_CH4, DMA_INT_HTF);
+    dma_interrupt_enable(DMA_CH4, DMA_INT_FTF);
+    nvic_irq_enable(DMA_Channel3_4_IRQn, 2, 0);
+    dma_channel_enable(DMA_CH4);
+
+    // 空闲线：一帧数据收完、不足半个缓冲区时也能及时交给主循环
+    usart_interrupt_enable(USART0, USART_INT_IDLE);
+    nvic_irq_enable(USART0_IRQn, 2, 0);
+    usart_dma_receive_config(USART0, USART_RECEIVE_DMA_ENABLE);
+}
+
+// 按 DMA 剩余计数推进 rx_head；两次调用之间 DMA 最多写半个缓冲区（半满中断保证），不会漏算一圈
+static void uart_rx_update(void)
+{
+    uint16_t pos = (uint16_t)(USART_RX_BUF_SIZE - dma_transfer_number_get(DMA_CH4));
+
+    if (pos == USART_RX_BUF_SIZE)
+        pos = 0;
+    rx_head += (uint16_t)(pos - rx_dma_pos) & (USART_RX_BUF_SIZE - 1U);
+    rx_dma_pos = pos;
+}
+
+// DMA_CH4 半满 / 全满、USART0 空闲线中断里调用
+void uart_rx_dma_isr(void) { uart_rx_update(); }
+
+// 读 DMA 当前位置，不等中断；可能在更高优先级的中断里调用，更新期间关中断
+static uint32_t uart_rx_head(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    uint32_t head;
+
+    __disable_irq();
+    uart_rx_update();
+    head = rx_head;
+    __set_PRIMASK(primask);
+    return head;
+}
+
+/**
+ * @brief 取接收缓冲区中连续可读的数据，不拷贝
+ * @param data 返回数据起始地址
+ * @return 可读字节数，缓冲区回绕处截断，读完这段再取下一段
+ * @note 数据已被 DMA 覆盖时丢弃积压的部分并计入 uart_rx_overrun()，调用者应重新同步帧头；
+ *       读位置只能由一处推进，主循环和中断不能同时读
+ */
+uint16_t uart_rx_peek(const uint8_t **data)
+{
+    uint32_t head = uart_rx_head();
+    uint16_t pos;
+    uint16_t len;
+
+    if (head - rx_tail > USART_RX_BUF_SIZE)
+    {
+        rx_overrun++;
+        rx_tail = head;
+    }
+    pos = rx_tail & (USART_RX_BUF_SIZE - 1U);
+    len = (uint16_t)(head - rx_tail);
+    if (len > USART_RX_BUF_SIZE - pos)
+        len = USART_RX_BUF_SIZE - pos;
+    *data = &rx_buf[pos];
+    return len;
+}
+
+// 释放 uart_rx_peek 取到的前 len 个字节
+void uart_rx_consume(uint16_t len) { rx_tail += len; }
+
+// 缓冲区中未读的字节数，包括回绕后的部分
+uint16_t uart_rx_pending(void)
+{
+    uint32_t n = uart_rx_head() - rx_tail;
+
+    return (n > USART_RX_BUF_SIZE) ? USART_RX_BUF_SIZE : (uint16_t)n;
+}
+
+// 接收缓冲区被覆盖的次数
+uint32_t uart_rx_overrun(void) { return rx_overrun; }
+#endif
+
 /**
  * @brief 串口初始化函数，使用 USART0（PA9=TX, PA10=RX）
  * @param baudrate 波特率，例如 115200
@@ -29,10 +230,23 @@ void uart_init(uint32_t baudrate)
 
     /* USART configure */
     usart_deinit(USART0);
+    // 波特率分频按过采样方式计算，必须先设过采样
+    if (baudrate > USART_OVS8_BAUD)
+        usart_oversample_config(USART0, USART_OVSMOD_8);
     usart_baudrate_set(USART0, baudrate);
     usart_transmit_config(USART0, USART_TRANSMIT_ENABLE);
     usart_receive_config(USART0, USART_RECEIVE_ENABLE);
+#if USART_RX_DMA
+    // 溢出时新数据覆盖旧数据，接收不停；丢失的字节由上层协议的帧头 / 校验发现
+    usart_overrun_disable(USART0);
+#endif
     usart_enable(USART0);
+#if USART_TX_DMA
+    uart_tx_dma_init();
+#endif
+#if USART_RX_DMA
+    uart_rx_dma_init();
+#endif
 }
 
 // 带行列号的增强版打印
@@ -54,12 +268,32 @@ void debug_print_matrix(const uint32_t *buf, uint16_t rows, uint16_t cols)
  * @param ch 要发送的字符
  * @param *f 文件指针（忽略）
  * @return 返回发送的字符
+ * @note  DMA 模式下只能在主循环里调用，不能在中断里 printf
  */
 int fputc(int ch, FILE *f)
 {
+#if USART_TX_DMA
+    if ((uint16_t)(tx_head - tx_tail) >= USART_TX_BUF_SIZE)
+    {
+        if (tx_policy == USART_TX_DROP)
+        {
+            tx_dropped++;
+            return ch;
+        }
+        while ((uint16_t)(tx_head - tx_tail) >= USART_TX_BUF_SIZE)
+            ;
+    }
+    tx_buf[tx_head & (USART_TX_BUF_SIZE - 1U)] = (uint8_t)ch;
+    tx_head++;
+    // 先推进 head 再看 DMA 是否空闲：完成中断插在两者之间时会看到新数据并接着发
+    if (tx_dma_len == 0)
+        uart_tx_dma_start();
+    return ch;
+#else
     usart_data_transmit(USART0, (uint8_t)ch);
     while (RESET == usart_flag_get(USART0, USART_FLAG_TBE))
         ;
 
     return ch;
+#endif
 }
@@ -6,6 +6,37 @@
 #include "gd32f1x0.h"
 #include "gd32f1x0_usart.h"
 
+// printf 写入发送环形缓冲区后立即返回，由 USART0 TX DMA（重映射到 DMA_CH3）在后台发出；
+// 置 0 则退回逐字节等待 TBE 的阻塞发送
+#define USART_TX_DMA 1
+#define USART_TX_BUF_SIZE 256 // 必须是 2 的幂
+
+// 缓冲区满时的处理方式
+#define USART_TX_DROP 0  // 丢弃新数据并计数，调用者从不等待
+#define USART_TX_BLOCK 1 // 等待 DMA 腾出空间，不丢数据
+#define USART_TX_POLICY USART_TX_DROP
+
+// 接收：循环 DMA（USART0_RX 重映射到 DMA_CH4）把数据写进环形缓冲区，
+// 半满 / 全满 / 空闲线中断更新写入位置，读取时也直接取 DMA 当前位置；用 uart_rx_peek / uart_rx_consume 取数据
+#define USART_RX_DMA 1
+#define USART_RX_BUF_SIZE 512 // 必须是 2 的幂，2 Mbaud 下约 2.5 ms 的数据
+
+// 超过该波特率改用 8 倍过采样：72 MHz 下最高 9 Mbaud，3 Mbaud 时分频无误差
+#define USART_OVS8_BAUD 1000000
+
 void uart_init(uint32_t baudrate);
 void debug_print_matrix(const uint32_t *buf, uint16_t rows, uint16_t cols);
+#if USART_TX_DMA
+void uart_tx_policy_set(uint8_t policy);
+uint32_t uart_tx_dropped(void);
+void uart_flush(void);
+void uart_tx_dma_isr(void);
+#endif
+#if USART_RX_DMA
+uint16_t uart_rx_peek(const uint8_t **data);
+void uart_rx_consume(uint16_t len);
+uint16_t uart_rx_pending(void);
+uint32_t uart_rx_overrun(void);
+void uart_rx_dma_isr(void);
+#endif
 #endif
\ No newline at end of file
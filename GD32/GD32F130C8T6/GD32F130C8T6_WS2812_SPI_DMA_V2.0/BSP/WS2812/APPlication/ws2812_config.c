@@ -0,0 +1,48 @@
+/* ws2812_config.c */
+#include "ws2812_config.h"
+
+// Flash 中的存储格式：魔数 + 灯数 + 灯数取反，三者都对上才认为有效
+typedef struct
+{
+    uint32_t magic;
+    uint32_t count;
+    uint32_t check;
+} WS2812_Config;
+
+// 读出保存的灯数，没有保存过或内容无效时返回默认值 WS2812_LED_NUM
+uint16_t WS2812_LoadLedCount(void)
+{
+    const WS2812_Config *cfg = (const WS2812_Config *)WS2812_CONFIG_ADDR;
+
+    if (cfg->magic != WS2812_CONFIG_MAGIC || cfg->check != ~cfg->count)
+        return WS2812_LED_NUM;
+    if (cfg->count == 0 || cfg->count > WS2812_LED_POOL)
+        return WS2812_LED_NUM;
+    return (uint16_t)cfg->count;
+}
+
+// 保存灯数：内容相同则跳过，避免无谓的擦写
+WS2812_Status WS2812_SaveLedCount(uint16_t count)
+{
+    const WS2812_Config *cfg = (const WS2812_Config *)WS2812_CONFIG_ADDR;
+    fmc_state_enum state;
+
+    if (count == 0 || count > WS2812_LED_POOL)
+        return WS2812_ERR_INVALID_PARAM;
+    if (cfg->magic == WS2812_CONFIG_MAGIC && cfg->count == count && cfg->check == ~(uint32_t)count)
+        return WS2812_OK;
+
+    fmc_unlock();
+    fmc_flag_clear(FMC_FLAG_END | FMC_FLAG_PGERR | FMC_FLAG_WPERR);
+    state = fmc_page_erase(WS2812_CONFIG_ADDR);
+    // 魔数最后写，中途掉电留下的半条记录不会被当成有效配置
+    if (state == FMC_READY)
+        state = fmc_word_program(WS2812_CONFIG_ADDR + 4U, count);
+    if (state == FMC_READY)
+        state = fmc_word_program(WS2812_CONFIG_ADDR + 8U, ~(uint32_t)count);
+    if (state == FMC_READY)
+        state = fmc_word_program(WS2812_CONFIG_ADDR, WS2812_CONFIG_MAGIC);
+    fmc_lock();
+
+    return (state == FMC_READY) ? WS2812_OK : WS2812_ERR_INVALID_PARAM;
+}
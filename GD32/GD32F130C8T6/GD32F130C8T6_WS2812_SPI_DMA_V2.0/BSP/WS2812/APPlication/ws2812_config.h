@@ -0,0 +1,15 @@
+/* ws2812_config.h - 灯带参数掉电保存 */
+#ifndef WS2812_CONFIG_H
+#define WS2812_CONFIG_H
+
+#include "ws2812_common.h"
+#include <stdint.h>
+
+// 使用 Flash 最后一页（1 KB）保存配置，工程的 IROM 大小相应减去这一页
+#define WS2812_CONFIG_ADDR 0x0800FC00U
+#define WS2812_CONFIG_MAGIC 0x57533132U // "WS12"
+
+uint16_t WS2812_LoadLedCount(void);
+WS2812_Status WS2812_SaveLedCount(uint16_t count);
+
+#endif
@@ -3,39 +3,241 @@
 #include "hal_ws2812.h"
 #include "systick.h"
 
-static WS2812_Buffer led_buffer;
+// 像素帧缓冲：每灯 3 字节 GRB，效果只读写这里，编码在 WS2812_Update 时统一进行
+static WS2812_Color led_pixels[WS2812_LED_POOL];
 
-WS2812_Status WS2812_Update(void) { return HAL_WS2812_SendFrame(&led_buffer); }
+// 波形缓冲区：双缓冲模式下两份轮流使用，led_back 为下一帧要编码的那份
+#if WS2812_DOUBLE_BUFFER
+#define WS2812_BUFFER_NUM 2
+#else
+#define WS2812_BUFFER_NUM 1
+#endif
 
-WS2812_Status WS2812_SetColor(uint16_t idx, WS2812_Color col, uint8_t bri)
+// 脏位图：每灯 1 bit，记录该波形缓冲区上次编码之后改动过的灯，WS2812_Update 只重编这些灯
+// 每份波形缓冲区各一张，双缓冲时后缓冲里是两帧之前的内容
+#define WS2812_DIRTY_WORDS ((WS2812_LED_POOL + 31) / 32)
+#define WS2812_DIRTY_ALL ((1U << WS2812_BUFFER_NUM) - 1)
+static uint32_t led_dirty[WS2812_BUFFER_NUM][WS2812_DIRTY_WORDS];
+static uint8_t led_dirty_all = WS2812_DIRTY_ALL; // 按 bit 对应各缓冲，上电时需整帧编码一次
+static uint16_t led_encoded;                     // 上一帧实际编码的灯数
+
+#if !WS2812_STREAM_MODE
+static WS2812_Buffer led_buffer[WS2812_BUFFER_NUM];
+static uint8_t led_back;
+
+static uint16_t WS2812_EncodeDirty(uint8_t b)
 {
-    if (idx >= WS2812_LED_NUM)
-        return WS2812_ERR_INVALID_PARAM;
+    uint16_t n = 0;
+    uint32_t *dirty = led_dirty[b];
 
-    uint32_t g = col.green * bri / 100;
-    uint32_t r = col.red * bri / 100;
-    uint32_t b = col.blue * bri / 100;
-    uint32_t pkt = (g << 16) | (r << 8) | b;
+    if (led_dirty_all & (1U << b))
+    {
+        led_dirty_all &= ~(1U << b);
+        for (uint16_t w = 0; w < WS2812_DIRTY_WORDS; w++)
+            dirty[w] = 0;
+        uint16_t count = HAL_WS2812_GetLedCount();
+        HAL_WS2812_Encode(&led_buffer[b], led_pixels, 0, count);
+        return count;
+    }
 
-    for (int bit = 0; bit < WS2812_BITS_PER_LED; bit++)
+    for (uint16_t w = 0; w < WS2812_DIRTY_WORDS; w++)
     {
-        led_buffer.buffer[idx][bit] = (pkt & (1U << (23 - bit))) ? WS2812_HIGH_CCR : WS2812_LOW_CCR;
+        uint32_t bits = dirty[w];
+        dirty[w] = 0;
+        while (bits)
+        {
+            // RBIT + CLZ 取最低置位 bit
+            uint16_t idx = w * 32 + __CLZ(__RBIT(bits));
+            bits &= bits - 1;
+            HAL_WS2812_Encode(&led_buffer[b], led_pixels, idx, 1);
+            n++;
+        }
+    }
+    return n;
+}
+#endif
+
+WS2812_Status WS2812_Update(void)
+{
+#if WS2812_STREAM_MODE
+    // 流式模式不需要整帧编码，由 DMA 中断边发边编
+    uint16_t count = HAL_WS2812_GetLedCount();
+    WS2812_Status st = HAL_WS2812_SendStream(led_pixels, count);
+    if (st == WS2812_OK)
+        led_encoded = count;
+    return st;
+#elif WS2812_DOUBLE_BUFFER
+    // 已有帧在排队时，后缓冲就是正在发送的那份，要等中断切换后才能编码
+    if (HAL_WS2812_SwapPending())
+        return WS2812_ERR_DMA_BUSY;
+
+    led_encoded = WS2812_EncodeDirty(led_back);
+    WS2812_Status st = HAL_WS2812_SendFrame(&led_buffer[led_back]);
+    if (st == WS2812_OK)
+        led_back ^= 1;
+    return st;
+#else
+    // DMA 仍在读波形缓冲区时不能改写它
+    if (HAL_WS2812_IsBusy())
+        return WS2812_ERR_DMA_BUSY;
+
+    led_encoded = WS2812_EncodeDirty(0);
+    return HAL_WS2812_SendFrame(&led_buffer[0]);
+#endif
+}
+
+// 上一次 WS2812_Update 实际编码的灯数，用于性能分析
+uint16_t WS2812_GetEncodedCount(void) { return led_encoded; }
+
+// 修改灯带长度：超出新长度的灯不再发送，变长时新增部分沿用帧缓冲里的旧值
+// 只改运行时长度，不写 Flash；需要掉电保存时由调用方在成功后调 WS2812_SaveLedCount
+WS2812_Status WS2812_SetLedCount(uint16_t count)
+{
+    WS2812_Status st = HAL_WS2812_SetLedCount(count);
+    if (st == WS2812_OK)
+        led_dirty_all = WS2812_DIRTY_ALL;
+    return st;
+}
+
+WS2812_Status WS2812_SetPixel(uint16_t idx, WS2812_Color col)
+{
+    if (idx >= HAL_WS2812_GetLedCount())
+        return WS2812_ERR_INVALID_PARAM;
+
+    WS2812_Color *p = &led_pixels[idx];
+    if (p->green != col.green || p->red != col.red || p->blue != col.blue || p->white != col.white)
+    {
+        *p = col;
+        for (uint8_t b = 0; b < WS2812_BUFFER_NUM; b++)
+            led_dirty[b][idx >> 5] |= 1UL << (idx & 31);
     }
     return WS2812_OK;
 }
 
-WS2812_Status WS2812_LIUSHUI(void)
+WS2812_Status WS2812_GetPixel(uint16_t idx, WS2812_Color *col)
+{
+    if (idx >= HAL_WS2812_GetLedCount() || col == NULL)
+        return WS2812_ERR_INVALID_PARAM;
+
+    *col = led_pixels[idx];
+    return WS2812_OK;
+}
+
+WS2812_Status WS2812_Fill(WS2812_Color col)
+{
+    uint16_t count = HAL_WS2812_GetLedCount();
+    for (uint16_t i = 0; i < count; i++)
+        led_pixels[i] = col;
+    led_dirty_all = WS2812_DIRTY_ALL;
+    return WS2812_OK;
+}
+
+// 按 0-255 的亮度缩放后写入帧缓冲
+WS2812_Status WS2812_SetPixelScaled(uint16_t idx, WS2812_Color col, uint8_t scale)
+{
+    col.green = WS2812_Scale8(col.green, scale);
+    col.red = WS2812_Scale8(col.red, scale);
+    col.blue = WS2812_Scale8(col.blue, scale);
+    col.white = WS2812_Scale8(col.white, scale);
+    return WS2812_SetPixel(idx, col);
+}
+
+// 兼容旧接口：bri 为 0-100，换算到 0-255（100 * 655 >> 8 = 255）
+WS2812_Status WS2812_SetColor(uint16_t idx, WS2812_Color col, uint8_t bri)
+{
+    if (bri > 100)
+        bri = 100;
+    return WS2812_SetPixelScaled(idx, col, (uint8_t)((bri * 655U) >> 8));
+}
+
+// 全局亮度 0-255，下次 WS2812_Update 时整帧重编生效
+void WS2812_SetBrightness(uint8_t bri)
+{
+    if (bri == HAL_WS2812_GetBrightness())
+        return;
+    HAL_WS2812_SetBrightness(bri);
+    led_dirty_all = WS2812_DIRTY_ALL;
+}
+
+// 效果均为单步函数，由调度器按返回的间隔（ms）调用，不在内部阻塞延时
+// DMA 忙导致本帧没发出去时，状态不前进，1 ms 后重试
+
+// 流水灯：单个点依次移动，走完一圈换一种颜色
+uint32_t WS2812_LiushuiStep(uint32_t now_ms)
 {
     static uint16_t pos = 0, color_i = 0;
     const uint8_t C = sizeof(colors) / sizeof(colors[0]);
-    for (int i = 0; i < WS2812_LED_NUM; i++)
-    {
-        WS2812_SetColor(i, (i == pos) ? colors[color_i] : (WS2812_Color){0, 0, 0}, (i == pos) ? 100 : 0);
-    }
-    WS2812_Update();
-    pos = (pos + 1) % WS2812_LED_NUM;
+    const uint16_t n = HAL_WS2812_GetLedCount();
+
+    if (pos >= n) // 灯数在运行中被改短
+        pos = 0;
+
+    // 帧缓冲保留上一帧内容，只需熄灭上一个点、点亮当前点
+    WS2812_SetPixel((pos + n - 1) % n, (WS2812_Color){0, 0, 0, 0});
+    WS2812_SetPixel(pos, colors[color_i]);
+    if (WS2812_Update() != WS2812_OK)
+        return 1;
+    pos = (pos + 1) % n;
     if (pos == 0)
         color_i = (color_i + 1) % C;
-    delay_1ms(50);
-    return WS2812_OK;
-}
\ No newline at end of file
+    return WS2812_LIUSHUI_MS;
+}
+
+// 全条灯带依次显示七种颜色，每种保持 WS2812_COLOR_CYCLE_MS
+uint32_t WS2812_ColorCycleStep(uint32_t now_ms)
+{
+    static uint8_t color_i = 0;
+    const uint8_t C = sizeof(colors) / sizeof(colors[0]);
+
+    WS2812_Fill(colors[color_i]);
+    if (WS2812_Update() != WS2812_OK)
+        return 1;
+    color_i = (color_i + 1) % C;
+    return WS2812_COLOR_CYCLE_MS;
+}
+
+// 色轮：0-255 依次过渡 红 -> 绿 -> 蓝 -> 红
+static WS2812_Color WS2812_Wheel(uint8_t pos)
+{
+    if (pos < 85)
+        return (WS2812_Color){(uint8_t)(pos * 3), (uint8_t)(255 - pos * 3), 0, 0};
+    if (pos < 170)
+    {
+        pos -= 85;
+        return (WS2812_Color){(uint8_t)(255 - pos * 3), 0, (uint8_t)(pos * 3), 0};
+    }
+    pos -= 170;
+    return (WS2812_Color){0, (uint8_t)(pos * 3), (uint8_t)(255 - pos * 3), 0};
+}
+
+// 彩虹：整条灯带铺满一圈色轮，每帧前移 2 格；供帧率节拍调用，每帧所有灯都会变
+void WS2812_RainbowRender(uint32_t frame)
+{
+    const uint16_t n = HAL_WS2812_GetLedCount();
+
+    for (uint16_t i = 0; i < n; i++)
+        WS2812_SetPixel(i, WS2812_Wheel((uint8_t)(i * 256U / n + frame * 2U)));
+}
+
+#if WS2812_ENCODE_BENCH
+// 用 DWT 周期计数器测三种编码方式每灯耗时，结果从串口打印
+void WS2812_EncodeBenchmark(void)
+{
+    static const char *const name[] = {"loop", "nibble", "byte"};
+    static WS2812_Slot scratch[WS2812_BITS_PER_LED] __attribute__((aligned(4)));
+    const uint16_t rounds = 256;
+
+    cycle_counter_init();
+    for (uint8_t enc = WS2812_ENCODER_LOOP; enc <= WS2812_ENCODER_BYTE; enc++)
+    {
+        uint32_t start = cycle_counter_get();
+        for (uint16_t i = 0; i < rounds; i++)
+        {
+            // 每轮换一个像素值，避免分支预测和常量折叠让结果偏乐观
+            HAL_WS2812_EncodeSlotsWith(enc, scratch, i * 0x010305U);
+        }
+        uint32_t cycles = cycle_counter_get() - start;
+        printf("[encode] %-6s %lu cycles/LED\n", name[enc], (unsigned long)(cycles / rounds));
+    }
+}
+#endif
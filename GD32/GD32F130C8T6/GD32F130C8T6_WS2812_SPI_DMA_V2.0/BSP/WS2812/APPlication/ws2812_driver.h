@@ -6,8 +6,30 @@
 #include <stdint.h>
 
 // 应用层接口
+WS2812_Status WS2812_SetPixel(uint16_t idx, WS2812_Color col);
+WS2812_Status WS2812_GetPixel(uint16_t idx, WS2812_Color *col);
+WS2812_Status WS2812_Fill(WS2812_Color col);
+WS2812_Status WS2812_SetPixelScaled(uint16_t idx, WS2812_Color col, uint8_t scale);
 WS2812_Status WS2812_SetColor(uint16_t idx, WS2812_Color col, uint8_t bri);
+void WS2812_SetBrightness(uint8_t bri);
+WS2812_Status WS2812_SetLedCount(uint16_t count);
 WS2812_Status WS2812_Update(void);
-WS2812_Status WS2812_LIUSHUI(void);
+uint16_t WS2812_GetEncodedCount(void);
+
+// 上电运行的效果：彩虹由帧率节拍驱动，流水灯和七色轮换由调度器按各自间隔调用
+#define WS2812_EFFECT_RAINBOW 0
+#define WS2812_EFFECT_LIUSHUI 1
+#define WS2812_EFFECT_COLOR_CYCLE 2
+#define WS2812_EFFECT WS2812_EFFECT_RAINBOW
+
+// 效果单步函数，返回距下次调用的毫秒数
+#define WS2812_LIUSHUI_MS 50
+#define WS2812_COLOR_CYCLE_MS 200
+uint32_t WS2812_LiushuiStep(uint32_t now_ms);
+uint32_t WS2812_ColorCycleStep(uint32_t now_ms);
+void WS2812_RainbowRender(uint32_t frame);
+#if WS2812_ENCODE_BENCH
+void WS2812_EncodeBenchmark(void);
+#endif
 
 #endif
\ No newline at end of file
@@ -0,0 +1,423 @@
+/* ws2812_host.c */
+#include "ws2812_host.h"
+#include "ws2812_driver.h"
+#include "ws2812_pacer.h"
+#include "ws2812_link.h"
+#include "hal_ws2812.h"
+#include "usart.h"
+#include <string.h>
+
+#if WS2812_HOST_LINK
+#if !USART_RX_DMA
+#error "WS2812_HOST_LINK 需要 usart.h 中的 USART_RX_DMA"
+#endif
+
+typedef enum
+{
+    HOST_HUNT, // 找帧头
+    HOST_ADA_D,
+    HOST_ADA_A,
+    HOST_ADA_HI,
+    HOST_ADA_LO,
+    HOST_ADA_CHK,
+    HOST_TPM2_TYPE,
+    HOST_TPM2_HI,
+    HOST_TPM2_LO,
+    HOST_DATA,    // 像素数据，两种协议共用
+    HOST_TPM2_TAIL,
+    HOST_LINK_SYNC, // 二进制帧，见 ws2812_link.h
+    HOST_LINK
+} WS2812_HostState;
+
+// 解析器逐字节推进，不要求一帧在一次 WS2812_HostFeed 里收全；
+// 像素先收进暂存区，整帧收完（TPM2 还要帧尾正确）才写进帧缓冲并置 ready 交给 WS2812_Update，
+// 坏帧不会写到灯上，上一帧等待发送期间收到的半帧也不会混进去
+static struct
+{
+    WS2812_HostState state;
+    uint8_t tpm2;     // 当前帧是 TPM2
+    uint8_t skip;     // TPM2 非像素帧，只跳过数据
+    uint8_t hi;       // 帧头中的长度高字节
+    uint8_t lo;       // Adalight 帧头中的长度低字节，校验通过后再用
+    uint32_t left;    // 剩余数据字节数
+#if WS2812_HOST_PIPELINE
+    uint8_t rgb[3];   // 正在拼的一个灯，像素不经过帧缓冲
+    uint8_t k;        // rgb[] 已收字节数
+#else
+    uint16_t staged;  // stage[] 已收字节数
+    uint8_t stage[3 * WS2812_LED_POOL]; // 本帧的 R G B，超出灯带容量的丢弃
+#endif
+    uint8_t ready;    // 有完整的新帧待发送
+    uint8_t active;   // 上位机在推流，本地效果已暂停
+    uint32_t last_ms; // 最近一次收到完整帧的时刻
+    uint32_t rx_overrun;
+#if WS2812_HOST_PIPELINE
+    uint8_t pipe_wait;      // 帧头已解析，等预收够数据后开始输出
+    volatile uint8_t piping; // 像素数据交给 DMA 中断读取，主循环不碰接收缓冲区
+    uint32_t underrun;      // 上次看到的 HAL 欠载计数
+#endif
+    WS2812_HostStats st;
+} host;
+
+// 在 HUNT 状态或帧头不匹配时检查当前字节是不是新的帧头
+static void WS2812_HostHunt(uint8_t b)
+{
+    if (b == 'A')
+        host.state = HOST_ADA_D;
+    else if (b == WS2812_TPM2_START)
+        host.state = HOST_TPM2_TYPE;
+    else if (b == WS2812_LINK_SYNC0)
+        host.state = HOST_LINK_SYNC;
+    else
+        host.state = HOST_HUNT;
+}
+
+static void WS2812_HostBeginData(uint32_t len)
+{
+#if WS2812_HOST_PIPELINE
+    host.k = 0;
+#else
+    host.staged = 0;
+#endif
+    host.left = len;
+    if (len == 0)
+        host.state = host.tpm2 ? HOST_TPM2_TAIL : HOST_HUNT;
+    else
+        host.state = HOST_DATA;
+}
+
+// 暂存的整帧写进帧缓冲；上位机按 R G B 发送，颜色顺序在编码时再按灯带重排，超出灯数的返回错误，忽略即可
+static void WS2812_HostApply(void)
+{
+#if !WS2812_HOST_PIPELINE
+    for (uint16_t i = 0; i + 3U <= host.staged; i += 3)
+    {
+        WS2812_Color c = {host.stage[i + 1], host.stage[i], host.stage[i + 2], 0};
+        WS2812_SetPixel(i / 3U, c);
+    }
+#endif
+}
+
+static void WS2812_HostCommit(void)
+{
+    host.ready = 1;
+    host.st.frames++;
+}
+
+/**
+ * @brief 解析上位机数据，整帧校验通过后像素写进帧缓冲
+ * @param data 收到的字节
+ * @param len 字节数
+ * @return 已处理的字节数；流水线模式下解析完像素帧的帧头就返回，剩下的数据交给 DMA 中断
+ * @note 超出灯带长度的像素丢弃
+ */
+uint16_t WS2812_HostFeed(const uint8_t *data, uint16_t len)
+{
+    for (uint16_t i = 0; i < len; i++)
+    {
+        uint8_t b = data[i];
+
+        switch (host.state)
+        {
+        case HOST_HUNT:
+            WS2812_HostHunt(b);
+            break;
+        case HOST_ADA_D:
+            if (b == 'd')
+                host.state = HOST_ADA_A;
+            else
+                WS2812_HostHunt(b);
+            break;
+        case HOST_ADA_A:
+            if (b == 'a')
+                host.state = HOST_ADA_HI;
+            else
+                WS2812_HostHunt(b);
+            break;
+        case HOST_ADA_HI:
+            host.hi = b;
+            host.state = HOST_ADA_LO;
+            break;
+        case HOST_ADA_LO:
+            host.lo = b;
+            host.state = HOST_ADA_CHK;
+            break;
+        case HOST_ADA_CHK:
+            if (b != (host.hi ^ host.lo ^ 0x55U))
+            {
+                host.st.bad++;
+                WS2812_HostHunt(b);
+                break;
+            }
+            host.tpm2 = 0;
+            host.skip = 0;
+            WS2812_HostBeginData((((uint32_t)host.hi << 8 | host.lo) + 1U) * 3U);
+            break;
+        case HOST_TPM2_TYPE:
+            host.skip = (b != WS2812_TPM2_DATA);
+            host.state = HOST_TPM2_HI;
+            break;
+        case HOST_TPM2_HI:
+            host.hi = b;
+            host.state = HOST_TPM2_LO;
+            break;
+        case HOST_TPM2_LO:
+            host.tpm2 = 1;
+            WS2812_HostBeginData((uint32_t)host.hi << 8 | b);
+            break;
+        case HOST_DATA:
+#if !WS2812_HOST_PIPELINE
+            if (!host.skip && host.staged < sizeof(host.stage))
+                host.stage[host.staged++] = b;
+#endif
+            if (--host.left == 0)
+            {
+                if (host.tpm2)
+                {
+                    host.state = HOST_TPM2_TAIL;
+                }
+                else
+                {
+                    if (!host.skip)
+                    {
+                        WS2812_HostApply();
+                        WS2812_HostCommit();
+                    }
+                    host.state = HOST_HUNT;
+                }
+            }
+            break;
+        case HOST_TPM2_TAIL:
+            if (b == WS2812_TPM2_END)
+            {
+                if (!host.skip)
+                {
+                    WS2812_HostApply();
+                    WS2812_HostCommit();
+                }
+                host.state = HOST_HUNT;
+            }
+            else
+            {
+                host.st.bad++;
+                WS2812_HostHunt(b);
+            }
+            break;
+        case HOST_LINK_SYNC:
+            if (b == WS2812_LINK_SYNC1)
+            {
+                WS2812_LinkBegin();
+                host.state = HOST_LINK;
+            }
+            else
+            {
+                WS2812_HostHunt(b);
+            }
+            break;
+        case HOST_LINK:
+            switch (WS2812_LinkPush(b))
+            {
+            case WS2812_LINK_MORE:
+                break;
+            case WS2812_LINK_FRAME:
+                WS2812_HostCommit();
+                host.state = HOST_HUNT;
+                break;
+            case WS2812_LINK_DROP:
+                host.st.bad++;
+                host.state = HOST_HUNT;
+                break;
+            default:
+                host.state = HOST_HUNT;
+                break;
+            }
+            break;
+        }
+#if WS2812_HOST_PIPELINE
+        if (host.state == HOST_DATA && !host.skip)
+        {
+            host.pipe_wait = 1;
+            return i + 1;
+        }
+#endif
+    }
+    return len;
+}
+
+#if WS2812_HOST_PIPELINE
+// 像素源：在流式发送的 DMA 中断里调用，直接从接收缓冲区取 R G B，不经过帧缓冲
+static uint16_t WS2812_HostPull(WS2812_Color *out, uint16_t max)
+{
+    const uint8_t *data;
+    uint16_t len;
+    uint16_t n = 0;
+    uint16_t backlog = uart_rx_pending();
+
+    if (backlog > host.st.backlog_max)
+        host.st.backlog_max = backlog;
+    while (n < max && host.left != 0 && (len = uart_rx_peek(&data)) != 0)
+    {
+        uint16_t i = 0;
+
+        // 数据已被覆盖，本帧剩下的像素不可信，按欠载结束
+        if (uart_rx_overrun() != host.rx_overrun)
+            break;
+        while (i < len && n < max && host.left != 0)
+        {
+            host.rgb[host.k++] = data[i++];
+            host.left--;
+            if (host.k == 3)
+            {
+                out[n].green = host.rgb[1];
+                out[n].red = host.rgb[0];
+                out[n].blue = host.rgb[2];
+                out[n].white = 0;
+                n++;
+                host.k = 0;
+            }
+        }
+        uart_rx_consume(i);
+    }
+    return n;
+}
+
+// 预收够数据后开始输出，灯数取帧长和灯带长度中较小的
+static void WS2812_HostPipeStart(void)
+{
+    uint16_t count = HAL_WS2812_GetLedCount();
+    uint32_t need = (uint32_t)WS2812_HOST_PIPE_PREFILL * 3U;
+
+    if (need > host.left)
+        need = host.left;
+    if (uart_rx_pending() < need || HAL_WS2812_IsBusy())
+        return;
+
+    host.pipe_wait = 0;
+    if (host.left / 3U < count)
+        count = (uint16_t)(host.left / 3U);
+    host.underrun = HAL_WS2812_StreamUnderrunCount();
+    host.piping = 1;
+    if (count == 0 || HAL_WS2812_SendStreamFrom(WS2812_HostPull, count) != WS2812_OK)
+    {
+        host.piping = 0;
+        host.skip = 1;
+    }
+}
+
+// 输出结束，本帧剩下的数据（超出灯带长度，或欠载后没发出去的）交回主循环跳过
+static void WS2812_HostPipeDone(void)
+{
+    host.piping = 0;
+    host.skip = 1;
+    host.st.frames++;
+    if (HAL_WS2812_StreamUnderrunCount() != host.underrun)
+        host.st.underrun++;
+    else
+        host.st.shown++;
+    if (host.left == 0)
+        host.state = host.tpm2 ? HOST_TPM2_TAIL : HOST_HUNT;
+}
+#endif
+
+// 取走"有新帧"标志
+uint8_t WS2812_HostFrameReady(void)
+{
+    uint8_t ready = host.ready;
+
+    host.ready = 0;
+    return ready;
+}
+
+void WS2812_HostInit(void)
+{
+    memset(&host, 0, sizeof(host));
+    host.state = HOST_HUNT;
+    WS2812_LinkInit();
+    // Adalight 上位机靠这行确认设备已就绪
+    printf("Ada\n");
+}
+
+// 调度器任务：取走接收缓冲区的数据交给解析器，收到完整帧就发出去
+uint32_t WS2812_HostStep(uint32_t now_ms)
+{
+    const uint8_t *data;
+    uint16_t len;
+
+#if WS2812_HOST_PIPELINE
+    if (host.piping)
+    {
+        if (HAL_WS2812_IsBusy())
+            return 1;
+        WS2812_HostPipeDone();
+    }
+#endif
+    while ((len = uart_rx_peek(&data)) != 0)
+    {
+        // 积压的数据被 DMA 覆盖过，当前帧已不完整，从下一个帧头重新开始
+        if (uart_rx_overrun() != host.rx_overrun)
+        {
+            host.rx_overrun = uart_rx_overrun();
+            host.st.overrun++;
+            host.state = HOST_HUNT;
+#if WS2812_HOST_PIPELINE
+            host.pipe_wait = 0;
+#endif
+        }
+        len = WS2812_HostFeed(data, len);
+        uart_rx_consume(len);
+#if WS2812_HOST_PIPELINE
+        if (host.pipe_wait)
+            break;
+#endif
+    }
+
+#if WS2812_HOST_PIPELINE
+    if (host.pipe_wait)
+    {
+        host.last_ms = now_ms;
+        if (!host.active)
+        {
+            host.active = 1;
+            WS2812_PacerPause(1);
+        }
+        WS2812_HostPipeStart();
+        return 1;
+    }
+#endif
+
+    if (host.ready)
+    {
+        host.last_ms = now_ms;
+        if (!host.active)
+        {
+            host.active = 1;
+            WS2812_PacerPause(1);
+        }
+        // 上一帧还在发送时留着标志，下一轮再试；期间到达的新帧直接覆盖
+        if (WS2812_Update() == WS2812_OK)
+        {
+            host.ready = 0;
+            host.st.shown++;
+        }
+    }
+    else if (host.active && now_ms - host.last_ms > WS2812_HOST_TIMEOUT_MS)
+    {
+        host.active = 0;
+        WS2812_PacerPause(0);
+    }
+    return 1;
+}
+
+void WS2812_HostGetStats(WS2812_HostStats *out) { *out = host.st; }
+
+// 串口打印统计
+void WS2812_HostReport(void)
+{
+    printf("[host] frames %lu, shown %lu, bad %lu, overrun %lu\n", (unsigned long)host.st.frames,
+           (unsigned long)host.st.shown, (unsigned long)host.st.bad, (unsigned long)host.st.overrun);
+    WS2812_LinkReport();
+#if WS2812_HOST_PIPELINE
+    printf("[host] pipeline underrun %lu, backlog max %u\n", (unsigned long)host.st.underrun, host.st.backlog_max);
+#endif
+}
+#endif
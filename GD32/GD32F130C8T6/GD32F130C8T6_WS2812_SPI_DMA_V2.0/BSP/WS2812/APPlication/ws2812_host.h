@@ -0,0 +1,52 @@
+/* ws2812_host.h - 上位机串口推流（Adalight / TPM2） */
+#ifndef WS2812_HOST_H
+#define WS2812_HOST_H
+
+#include "ws2812_common.h"
+#include <stdint.h>
+
+// 置 1 时 USART0 接收上位机（Prismatik、Hyperion 等）发来的像素帧，整帧校验通过后写进帧缓冲；
+// 收到帧后暂停本地效果（节拍器驱动的 WS2812_EFFECT_RAINBOW），超时没有新帧再恢复
+// 解析器只认字节流（WS2812_HostFeed），与传输方式无关；GD32F130 没有 USBD 外设，
+// 工程里的 usbd 库只能用于 GD32F150，因此这里只接了 USART0
+#define WS2812_HOST_LINK 1
+#define WS2812_HOST_BAUD 2000000   // 上位机串口波特率，最高 3 Mbaud，需 USB 转串口芯片支持
+#define WS2812_HOST_TIMEOUT_MS 2000
+
+// 流水线：像素数据不进帧缓冲，由流式发送的 DMA 中断直接从接收缓冲区取、边收边发，
+// 第 N 帧还在接收时就开始输出，延迟与灯带长度无关；只用于流式模式，其他模式下自动关闭
+// 串口要比线上快（800 kHz 灯带约 100 KB/s，即 1 Mbaud 以上），否则会欠载
+#define WS2812_HOST_PIPELINE 1
+#define WS2812_HOST_PIPE_PREFILL 4 // 开始输出前先收齐的灯数，吸收串口数据的抖动
+#if !WS2812_STREAM_MODE
+#undef WS2812_HOST_PIPELINE
+#define WS2812_HOST_PIPELINE 0
+#endif
+
+// Adalight：'A' 'd' 'a' 灯数-1 高字节 低字节 校验(高 ^ 低 ^ 0x55)，随后每灯 R G B
+// TPM2：0xC9 类型 长度高字节 低字节 数据 0x36，类型 0xDA 为像素数据，每灯 R G B
+// 另外支持带 CRC 校验的二进制帧，以 0xA5 0x5A 开头，见 ws2812_link.h
+#define WS2812_TPM2_START 0xC9
+#define WS2812_TPM2_DATA 0xDA
+#define WS2812_TPM2_END 0x36
+
+typedef struct
+{
+    uint32_t frames;  // 完整收到并提交的帧数
+    uint32_t shown;   // 已发到灯带的帧数，上位机发得比灯带快时少于 frames
+    uint32_t bad;     // 校验、帧尾或 CRC 错误、被丢弃的帧数
+    uint32_t overrun; // 接收缓冲区被覆盖、重新找帧头的次数
+#if WS2812_HOST_PIPELINE
+    uint32_t underrun;    // 流水线输出时数据没跟上、帧被提前结束的次数
+    uint16_t backlog_max; // 流水线输出期间接收缓冲区积压的最大字节数，接近缓冲区大小说明串口太快
+#endif
+} WS2812_HostStats;
+
+void WS2812_HostInit(void);
+uint16_t WS2812_HostFeed(const uint8_t *data, uint16_t len);
+uint8_t WS2812_HostFrameReady(void);
+uint32_t WS2812_HostStep(uint32_t now_ms);
+void WS2812_HostGetStats(WS2812_HostStats *out);
+void WS2812_HostReport(void);
+
+#endif
@@ -0,0 +1,138 @@
+/* ws2812_link.c */
+#include "ws2812_link.h"
+#include "ws2812_driver.h"
+#include "ws2812_config.h"
+#include <string.h>
+
+// 整帧先收进按字对齐的缓冲区，CRC 通过后才解析负载；负载补齐后加上 CRC 本身的 4 字节
+#define WS2812_LINK_WORDS ((WS2812_LINK_HEADER + WS2812_LINK_MAX_PAYLOAD + 3) / 4 + 1)
+
+static struct
+{
+    uint32_t buf[WS2812_LINK_WORDS];
+    uint16_t pos;   // 已收字节数
+    uint16_t total; // 整帧字节数，帧头收齐后确定
+    uint8_t seq;    // 期望的下一个序号
+    uint8_t synced; // 已收到过有效帧，序号可以比较
+    WS2812_LinkStats st;
+} link;
+
+// 开启 CRC 时钟，配置成与 zlib crc32 一致：按字整体位反转输入、输出反转，初值全 1，结果取反
+void WS2812_LinkInit(void)
+{
+    rcu_periph_clock_enable(RCU_CRC);
+    crc_deinit();
+    crc_input_data_reverse_config(CRC_INPUT_DATA_WORD);
+    crc_reverse_output_data_enable();
+    memset(&link, 0, sizeof(link));
+}
+
+// 解析器已收到同步字，开始收一帧
+void WS2812_LinkBegin(void)
+{
+    ((uint8_t *)link.buf)[0] = WS2812_LINK_SYNC0;
+    ((uint8_t *)link.buf)[1] = WS2812_LINK_SYNC1;
+    link.pos = 2;
+    link.total = 0;
+}
+
+static uint16_t WS2812_LinkGet16(const uint8_t *p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+
+// 校验通过后执行
+static WS2812_LinkResult WS2812_LinkDispatch(uint8_t type, const uint8_t *p, uint16_t len)
+{
+    switch (type)
+    {
+    case WS2812_LINK_PIXELS:
+        if (len < 2)
+            break;
+        for (uint16_t i = 2, idx = WS2812_LinkGet16(p); i + 3 <= len; i += 3, idx++)
+        {
+            WS2812_Color c = {p[i + 1], p[i], p[i + 2], 0};
+            WS2812_SetPixel(idx, c); // 超出灯带长度的返回错误，忽略
+        }
+        return WS2812_LINK_FRAME;
+    case WS2812_LINK_BRIGHTNESS:
+        if (len < 1)
+            break;
+        WS2812_SetBrightness(p[0]);
+        return WS2812_LINK_FRAME;
+    case WS2812_LINK_LED_COUNT:
+        if (len < 2)
+            break;
+        // 生效后写进 Flash，下次上电沿用；灯数没变时不擦写
+        if (WS2812_SetLedCount(WS2812_LinkGet16(p)) == WS2812_OK)
+            WS2812_SaveLedCount(WS2812_LinkGet16(p));
+        return WS2812_LINK_DONE;
+    default:
+        break;
+    }
+    link.st.hdr_err++;
+    return WS2812_LINK_DROP;
+}
+
+static WS2812_LinkResult WS2812_LinkCheck(void)
+{
+    const uint8_t *b = (const uint8_t *)link.buf;
+    uint16_t words = (uint16_t)(link.total / 4U - 1U);
+    uint32_t crc;
+
+    crc_data_register_reset();
+    crc = crc_block_data_calculate(link.buf, words, INPUT_FORMAT_WORD) ^ 0xFFFFFFFFU;
+    if (crc != link.buf[words])
+    {
+        link.st.crc_err++;
+        return WS2812_LINK_DROP;
+    }
+
+    link.st.frames++;
+    if (link.synced)
+    {
+        uint8_t d = (uint8_t)(b[3] - link.seq);
+
+        // 差值在前半圈算向前跳过的帧；后半圈是重发、乱序或上位机重启，单独计数，序号照样跟上
+        if (d < 128U)
+            link.st.seq_gap += d;
+        else
+            link.st.seq_old++;
+    }
+    link.synced = 1;
+    link.seq = (uint8_t)(b[3] + 1U);
+    return WS2812_LinkDispatch(b[2], b + WS2812_LINK_HEADER, WS2812_LinkGet16(b + 4));
+}
+
+/**
+ * @brief 收一个字节
+ * @param b 收到的字节
+ * @return 帧未收完返回 WS2812_LINK_MORE，否则为本帧的处理结果，调用者回到找帧头状态
+ */
+WS2812_LinkResult WS2812_LinkPush(uint8_t b)
+{
+    uint8_t *p = (uint8_t *)link.buf;
+
+    p[link.pos++] = b;
+    if (link.pos == WS2812_LINK_HEADER)
+    {
+        uint16_t len = WS2812_LinkGet16(p + 4);
+
+        if ((len ^ WS2812_LinkGet16(p + 6)) != 0xFFFFU || len > WS2812_LINK_MAX_PAYLOAD)
+        {
+            link.st.hdr_err++;
+            return WS2812_LINK_DROP;
+        }
+        link.total = (uint16_t)(WS2812_LINK_HEADER + ((len + 3U) & ~3U) + 4U);
+    }
+    if (link.total == 0 || link.pos < link.total)
+        return WS2812_LINK_MORE;
+    return WS2812_LinkCheck();
+}
+
+void WS2812_LinkGetStats(WS2812_LinkStats *out) { *out = link.st; }
+
+// 串口打印统计
+void WS2812_LinkReport(void)
+{
+    printf("[link] frames %lu, crc err %lu, hdr err %lu, seq gap %lu, seq old %lu\n", (unsigned long)link.st.frames,
+           (unsigned long)link.st.crc_err, (unsigned long)link.st.hdr_err, (unsigned long)link.st.seq_gap,
+           (unsigned long)link.st.seq_old);
+}
@@ -0,0 +1,51 @@
+/* ws2812_link.h - 带 CRC 校验的二进制帧协议 */
+#ifndef WS2812_LINK_H
+#define WS2812_LINK_H
+
+#include "ws2812_common.h"
+#include <stdint.h>
+
+// 帧格式（多字节字段均为小端）：
+//   0  0xA5 0x5A           同步字
+//   2  type                帧类型，见下
+//   3  seq                 序号，每帧加 1，用来统计丢帧
+//   4  len                 负载字节数，uint16
+//   6  ~len                长度取反，帧头自检，乱码不会让解析器空等一个超长负载
+//   8  payload[len]        之后补 0 到 4 字节对齐
+//   .. crc                 CRC-32（与 zlib crc32 相同），覆盖同步字到补齐后的负载，uint32
+// 整帧按字对齐，由 CRC 外设以字格式计算；校验失败的帧整帧丢弃，不会写到灯带上
+#define WS2812_LINK_SYNC0 0xA5
+#define WS2812_LINK_SYNC1 0x5A
+#define WS2812_LINK_HEADER 8
+
+#define WS2812_LINK_PIXELS 0x01     // 起始灯号 uint16 + 每灯 R G B，收完即发送
+#define WS2812_LINK_BRIGHTNESS 0x02 // 全局亮度 uint8
+#define WS2812_LINK_LED_COUNT 0x03  // 灯带长度 uint16，同时保存到 Flash
+
+#define WS2812_LINK_MAX_PAYLOAD (2 + 3 * WS2812_LED_POOL)
+
+// WS2812_LinkPush 的返回值
+typedef enum
+{
+    WS2812_LINK_MORE,  // 帧未收完
+    WS2812_LINK_DONE,  // 命令帧已执行
+    WS2812_LINK_FRAME, // 像素帧已写进帧缓冲，需要发送
+    WS2812_LINK_DROP   // 帧头、长度或 CRC 错误，整帧丢弃
+} WS2812_LinkResult;
+
+typedef struct
+{
+    uint32_t frames;  // 校验通过的帧数
+    uint32_t crc_err; // CRC 错误的帧数
+    uint32_t hdr_err; // 同步字、长度或类型错误的帧数
+    uint32_t seq_gap; // 按序号推算丢失的帧数：上位机发得慢只会帧少，序号有缺口才说明链路在丢帧
+    uint32_t seq_old; // 序号重复或倒退的帧数（上位机重发、乱序或重启），不计入 seq_gap，帧照常执行
+} WS2812_LinkStats;
+
+void WS2812_LinkInit(void);
+void WS2812_LinkBegin(void);
+WS2812_LinkResult WS2812_LinkPush(uint8_t b);
+void WS2812_LinkGetStats(WS2812_LinkStats *out);
+void WS2812_LinkReport(void);
+
+#endif
@@ -0,0 +1,159 @@
+/* ws2812_pacer.c */
+#include "ws2812_pacer.h"
+#include "ws2812_driver.h"
+#include "systick.h"
+#include <string.h>
+
+// 节拍用 DWT 周期计数做时基，1 ms 的 SysTick 只负责把任务唤醒到截止时刻前 1 ms 以内；
+// 之后每次返回 0 让调度器先跑其他任务再回来检查，只有最后 WS2812_PACER_SPIN_US 以内才忙等，
+// 帧起始抖动取决于其他任务单步的最长耗时
+static struct
+{
+    WS2812_RenderFn render;
+    uint32_t period_cyc; // 帧周期（周期数）
+    uint32_t deadline;   // 下一帧计划开始时刻（周期数）
+    uint32_t frame;      // 下一帧序号，传给渲染回调
+    uint32_t start_ms;   // 统计窗口起点
+    uint8_t started;
+    uint8_t paused;
+    WS2812_PacerStats st;
+} pacer;
+
+static const uint16_t jitter_limit[WS2812_PACER_JITTER_BUCKETS - 1] = WS2812_PACER_JITTER_LIMITS;
+
+/**
+ * @brief 设置目标帧率和渲染回调
+ * @param fps 目标帧率，1 ~ 1000
+ * @param render 渲染回调
+ */
+WS2812_Status WS2812_PacerInit(uint16_t fps, WS2812_RenderFn render)
+{
+    if (fps == 0 || fps > 1000 || render == NULL)
+        return WS2812_ERR_INVALID_PARAM;
+
+    pacer.render = render;
+    pacer.period_cyc = SystemCoreClock / fps;
+    pacer.frame = 0;
+    // 截止时刻在第一次运行时再取，调度器启动时会清零 DWT 计数
+    pacer.started = 0;
+    WS2812_PacerResetStats();
+    pacer.st.target_fps = fps;
+    return WS2812_OK;
+}
+
+static void WS2812_PacerJitter(uint32_t us)
+{
+    uint8_t b = 0;
+
+    while (b < WS2812_PACER_JITTER_BUCKETS - 1 && us > jitter_limit[b])
+        b++;
+    pacer.st.jitter_hist[b]++;
+    if (us > pacer.st.jitter_max_us)
+        pacer.st.jitter_max_us = us;
+}
+
+// 调度器任务：到截止时刻渲染一帧并发送，返回距下一帧的毫秒数
+uint32_t WS2812_PacerStep(uint32_t now_ms)
+{
+    const uint32_t cyc_per_ms = SystemCoreClock / 1000U;
+    const uint32_t cyc_per_us = SystemCoreClock / 1000000U;
+    uint32_t now = cycle_counter_get();
+    int32_t late;
+
+    if (pacer.render == NULL)
+        return 1000;
+    if (pacer.paused)
+        return 10;
+    if (!pacer.started)
+    {
+        pacer.started = 1;
+        pacer.deadline = now;
+    }
+
+    late = (int32_t)(now - pacer.deadline);
+    if (late < 0)
+    {
+        // 还差 1 ms 以上就继续睡；不到 1 ms 时让出 CPU，下一轮调度再查；只剩几微秒才忙等到截止时刻
+        if ((uint32_t)-late > cyc_per_ms)
+            return (uint32_t)-late / cyc_per_ms;
+        if ((uint32_t)-late > WS2812_PACER_SPIN_US * cyc_per_us)
+            return 0;
+        while ((int32_t)(cycle_counter_get() - pacer.deadline) < 0)
+        {
+        }
+        late = 0;
+        now = pacer.deadline;
+    }
+    WS2812_PacerJitter((uint32_t)late / cyc_per_us);
+
+    pacer.render(pacer.frame++);
+    if (WS2812_Update() == WS2812_OK)
+        pacer.st.frames++;
+    else
+        pacer.st.dropped++;
+
+    uint32_t us = (cycle_counter_get() - now) / cyc_per_us;
+    pacer.st.render_last_us = us;
+    if (us > pacer.st.render_max_us)
+        pacer.st.render_max_us = us;
+
+    // 以计划时刻推进；落后超过一个周期时不追帧，从当前时刻重新对齐
+    pacer.deadline += pacer.period_cyc;
+    now = cycle_counter_get();
+    if ((int32_t)(now - pacer.deadline) >= 0)
+    {
+        pacer.st.overrun += ((uint32_t)(now - pacer.deadline)) / pacer.period_cyc + 1;
+        pacer.deadline = now + pacer.period_cyc;
+    }
+    return (pacer.deadline - now) / cyc_per_ms;
+}
+
+/**
+ * @brief 暂停 / 恢复节拍，例如帧缓冲改由上位机写入时
+ * @param pause 1 暂停，0 恢复；恢复后从当前时刻重新对齐，不计入落后的节拍
+ */
+void WS2812_PacerPause(uint8_t pause)
+{
+    pacer.paused = pause;
+    pacer.started = 0;
+}
+
+void WS2812_PacerGetStats(WS2812_PacerStats *out)
+{
+    uint32_t elapsed = systick_ms_get() - pacer.start_ms;
+
+    pacer.st.fps_x10 = elapsed ? (uint16_t)((uint64_t)pacer.st.frames * 10000U / elapsed) : 0;
+    *out = pacer.st;
+}
+
+// 清零统计并开始新的统计窗口
+void WS2812_PacerResetStats(void)
+{
+    uint16_t fps = pacer.st.target_fps;
+
+    memset(&pacer.st, 0, sizeof(pacer.st));
+    pacer.st.target_fps = fps;
+    pacer.start_ms = systick_ms_get();
+}
+
+// 串口打印统计
+void WS2812_PacerReport(void)
+{
+    WS2812_PacerStats s;
+
+    WS2812_PacerGetStats(&s);
+    printf("[pacer] target %u fps, actual %u.%u fps, frames %lu, dropped %lu, overrun %lu\n", s.target_fps,
+           s.fps_x10 / 10U, s.fps_x10 % 10U, (unsigned long)s.frames, (unsigned long)s.dropped,
+           (unsigned long)s.overrun);
+    printf("[pacer] render last %lu us, max %lu us, jitter max %lu us\n", (unsigned long)s.render_last_us,
+           (unsigned long)s.render_max_us, (unsigned long)s.jitter_max_us);
+    printf("[pacer] jitter");
+    for (uint8_t b = 0; b < WS2812_PACER_JITTER_BUCKETS; b++)
+    {
+        if (b < WS2812_PACER_JITTER_BUCKETS - 1)
+            printf(" <=%u:%lu", jitter_limit[b], (unsigned long)s.jitter_hist[b]);
+        else
+            printf(" >%u:%lu", jitter_limit[b - 1], (unsigned long)s.jitter_hist[b]);
+    }
+    printf("\n");
+}
@@ -0,0 +1,37 @@
+/* ws2812_pacer.h - 固定帧率节拍 */
+#ifndef WS2812_PACER_H
+#define WS2812_PACER_H
+
+#include "ws2812_common.h"
+#include <stdint.h>
+
+#define WS2812_PACER_FPS 60 // 默认目标帧率
+#define WS2812_PACER_SPIN_US 20 // 离截止时刻不到这么多微秒时忙等，更早则返回调度器
+// 抖动直方图分档上限（us），最后一档收集超过最大上限的帧
+#define WS2812_PACER_JITTER_BUCKETS 6
+#define WS2812_PACER_JITTER_LIMITS {50, 100, 250, 500, 1000}
+
+// 渲染回调：把第 frame 帧写进帧缓冲，不需要调用 WS2812_Update
+typedef void (*WS2812_RenderFn)(uint32_t frame);
+
+typedef struct
+{
+    uint16_t target_fps;
+    uint16_t fps_x10;         // 统计窗口内实际发出的帧率 x10
+    uint32_t frames;          // 已发出的帧数
+    uint32_t dropped;         // 因 DMA 忙没能发出的帧数
+    uint32_t overrun;         // 落后超过一个周期、被跳过的节拍数
+    uint32_t render_last_us;  // 上一帧渲染 + 编码耗时
+    uint32_t render_max_us;   // 最长渲染 + 编码耗时
+    uint32_t jitter_max_us;   // 实际开始时刻相对计划时刻的最大偏差
+    uint32_t jitter_hist[WS2812_PACER_JITTER_BUCKETS];
+} WS2812_PacerStats;
+
+WS2812_Status WS2812_PacerInit(uint16_t fps, WS2812_RenderFn render);
+uint32_t WS2812_PacerStep(uint32_t now_ms);
+void WS2812_PacerPause(uint8_t pause);
+void WS2812_PacerGetStats(WS2812_PacerStats *out);
+void WS2812_PacerResetStats(void);
+void WS2812_PacerReport(void);
+
+#endif
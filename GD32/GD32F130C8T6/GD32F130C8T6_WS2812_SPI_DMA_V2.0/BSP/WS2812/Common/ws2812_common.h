@@ -11,29 +11,157 @@ typedef enum {
     WS2812_ERR_INVALID_PARAM
 } WS2812_Status;  // 状态码定义
 
-#define WS2812_LED_NUM 30
-#define WS2812_RESET_FRAMES 3
+// 多路并行：TIMER1 的 WS2812_MULTI_FIRST_CH 起连续 WS2812_MULTI_LANES 个通道（CH0 PA0、CH1 PA1、
+// CH2 PB10、CH3 PB11）同时输出，DMA 突发传输每个周期写入全部通道；0 或 1 为单路（CH2 PB10）
+// 各路共用一个协议时序，灯数和颜色顺序可以不同；应用层把各路按顺序拼成一条逻辑灯带
+#define WS2812_MULTI_LANES 0
+#define WS2812_MULTI_FIRST_CH 0
+#define WS2812_MULTI_LED_POOL 30 // 每路最大灯数
+
+// GPIO 并行：TIMER1 每个 bit 周期触发三次 DMA，直接写 GPIOB 的 BOP / BC 寄存器，
+// PB0 起连续 WS2812_GPIO_LANES 个引脚（最多 8 路）同时输出；每个槽位 1 字节存放各路的同一 bit，
+// 波形缓冲区大小与路数无关。与 WS2812_MULTI_LANES 互斥，0 或 1 为关闭
+#define WS2812_GPIO_LANES 0
+#define WS2812_GPIO_LED_POOL 30 // 每路最大灯数
+
+// 并行输出的路数和每路最大灯数，单路时为 1
+#if (WS2812_MULTI_LANES > 1)
+#define WS2812_LANES WS2812_MULTI_LANES
+#define WS2812_LANE_LED_POOL WS2812_MULTI_LED_POOL
+#elif (WS2812_GPIO_LANES > 1)
+#define WS2812_LANES WS2812_GPIO_LANES
+#define WS2812_LANE_LED_POOL WS2812_GPIO_LED_POOL
+#else
+#define WS2812_LANES 1
+#endif
+
+#if (WS2812_LANES > 1)
+#define WS2812_LED_POOL (WS2812_LANES * WS2812_LANE_LED_POOL)
+#else
+#define WS2812_LED_POOL 60 // 静态预留的最大灯数，决定缓冲区大小
+#endif
+#define WS2812_LED_NUM 30  // 默认灯数，Flash 中没有保存的配置时使用
+#define WS2812_RESET_FRAMES 3     // 默认复位长度（灯数），不足协议最短复位时间时自动加长
+#define WS2812_RESET_ROWS_MAX 10  // 缓冲区为复位预留的行数，按最长的 WS2813 280 us 锁存计算
+// 颜色顺序：帧缓冲统一按 WS2812_Color 存放，编码时按灯带的顺序重排；下标见 hal_ws2812_encode.c
+#define WS2812_ORDER_GRB 0 // WS2812 / WS2813 / SK6812
+#define WS2812_ORDER_RGB 1 // WS2811 多数为此顺序
+#define WS2812_ORDER_BRG 2
+#define WS2812_ORDER_RBG 3
+#define WS2812_ORDER_GBR 4
+#define WS2812_ORDER_BGR 5
+#define WS2812_ORDER_GRBW 6 // SK6812 RGBW，每灯 32 bit
+#define WS2812_ORDER_RGBW 7
+#define WS2812_ORDER_NUM 8
+#define WS2812_COLOR_ORDER WS2812_ORDER_GRB // 默认颜色顺序
+
+// 置 1 时编译 32 位 RGBW 支持，波形缓冲区按每灯 32 个槽位分配
+#ifndef WS2812_RGBW
+#define WS2812_RGBW 0
+#endif
+// RGBW 灯自动提取白色：min(r, g, b) 由白色通道发光，RGB 各减去这部分
+#define WS2812_AUTO_WHITE 1
+
+#if WS2812_RGBW
+#define WS2812_BITS_PER_LED 32 // 每灯最大槽位数
+#else
 #define WS2812_BITS_PER_LED 24
-#define RGB_ARRAY_SIZE (WS2812_LED_NUM + WS2812_RESET_FRAMES)
-#define WS2812_HIGH_CCR 57
-#define WS2812_LOW_CCR 28
-// 颜色格式定义
+#endif
+
+// 协议时序，见 hal_ws2812_timing.c 中的时序表
+#define WS2812_PROTO_WS2812B 0 // 800 kHz
+#define WS2812_PROTO_WS2811 1  // 400 kHz 低速模式
+#define WS2812_PROTO_SK6812 2
+#define WS2812_PROTO_WS2813 3  // 锁存 280 us
+#define WS2812_PROTO_FAST 4    // 缩短 bit 周期到容差边缘，提高刷新率，需实测灯带能否稳定接收
+#define WS2812_PROTO_NUM 5
+#define WS2812_PROTOCOL WS2812_PROTO_WS2812B // 默认协议
+
+// 最短锁存：复位只发协议要求的最短时间，而不是 WS2812_RESET_FRAMES 整行，帧率更高
+#define WS2812_MIN_LATCH 0
+
+// DMA 波形缓冲区位宽：32 = 每 bit 一个 uint32_t；16 = 半字存储，RAM 减半；
+// 8 = 字节存储，只剩 1/4（要求 1 码比较值 < 256，初始化时检查）
+// DMA 按该位宽读内存、32 位写 CH2CV，高位自动补零；Test 目录下的主机测试在命令行上覆盖
+#ifndef WS2812_DMA_WIDTH
+#define WS2812_DMA_WIDTH 16
+#endif
+
+// 位展开方式：LOOP = 逐 bit 判断；NIBBLE = 16 项查表（Flash 占用小）；
+// BYTE = 256 项查表（最快，Flash 占用 2/4/8 KB 对应 8/16/32 位槽位）
+#define WS2812_ENCODER_LOOP 0
+#define WS2812_ENCODER_NIBBLE 1
+#define WS2812_ENCODER_BYTE 2
+#define WS2812_ENCODER WS2812_ENCODER_NIBBLE
+// 置 1 时三种编码都编译进来，并提供 WS2812_EncodeBenchmark() 用 DWT 周期计数对比
+#ifndef WS2812_ENCODE_BENCH
+#define WS2812_ENCODE_BENCH 0
+#endif
+
+// 编码时做 gamma 2.2 校正（Flash 查表），亮度调节在感知上更线性
+#define WS2812_GAMMA 1
+
+// 流式发送：DMA 循环读一个 2 x N 灯的乒乓缓冲区，中断里从 3 字节/灯的像素数组补填，
+// 灯带长度不再受波形缓冲区 RAM 限制
+#define WS2812_STREAM_MODE 0
+#define WS2812_STREAM_LEDS_PER_HALF 2
+
+// 输出方式，由 WS2812_StripConfig.backend 在初始化时选择
+#define WS2812_BACKEND_TIMER 0 // TIMER1 CH2 PWM（PB10），每 bit 一个比较值槽位
+#define WS2812_BACKEND_SPI 1   // SPI0 MOSI（PA7），每 bit 展开成 3 / 4 个 SPI 位，缓冲区约为 1/5 ~ 1/10
+#define WS2812_BACKEND_USART 2 // USART1 TX（PA2）反相输出，每个 UART 字节发 2 bit，每灯 12 字节
+#define WS2812_BACKEND WS2812_BACKEND_TIMER // 默认输出方式
+// 置 1 时编译对应后端（只用于单路非流式发送，多路 / GPIO 并行 / 流式模式下自动关闭）
+// USART 后端与 printf 的 TX DMA（usart.h 中 USART_TX_DMA）共用 DMA_CH3，只能开启一个
+#define WS2812_SPI_BACKEND 1
+#define WS2812_USART_BACKEND 0
+#if (WS2812_LANES > 1) || WS2812_STREAM_MODE
+#undef WS2812_SPI_BACKEND
+#define WS2812_SPI_BACKEND 0
+#undef WS2812_USART_BACKEND
+#define WS2812_USART_BACKEND 0
+#endif
+
+// 双缓冲：两份波形缓冲区，DMA 发送前缓冲的同时编码后缓冲，传输完成中断里切换
+// RAM 占用翻倍，灯数较多时需配合 WS2812_DMA_WIDTH 8 使用；与流式模式互斥
+#define WS2812_DOUBLE_BUFFER 0
+
+// 锁存重叠：DMA 只发数据和一个 0 槽位，锁存时间由 TIMER1 临时加长 ARR、更新中断计时，不占缓冲区；
+// 锁存期间缓冲区已空闲，可以编码并提交下一帧，锁存一结束就发出第一个 bit。
+// 只用于单路定时器输出，流式 / 双缓冲 / 多路模式下自动关闭
+#define WS2812_TIMER_LATCH 1
+#if (WS2812_LANES > 1) || WS2812_STREAM_MODE || WS2812_DOUBLE_BUFFER
+#undef WS2812_TIMER_LATCH
+#define WS2812_TIMER_LATCH 0
+#endif
+
+// 波形缓冲区行数：有效灯之后预留复位行；锁存由定时器计时时不再预留
+#if WS2812_TIMER_LATCH
+#define RGB_ARRAY_SIZE WS2812_LED_POOL
+#else
+#define RGB_ARRAY_SIZE (WS2812_LED_POOL + WS2812_RESET_ROWS_MAX)
+#endif
+// 颜色格式定义，white 只在 RGBW 灯带上使用，RGB 灯带忽略
 typedef struct
 {
     uint8_t green;
     uint8_t red;
     uint8_t blue;
+    uint8_t white;
 } WS2812_Color;
 
-// 七种颜色（正常 RGB 顺序）
+// 0-255 亮度缩放：乘法 + 移位代替除法，scale = 255 时原值不变
+static inline uint8_t WS2812_Scale8(uint8_t v, uint8_t scale) { return (uint8_t)((v * (scale + 1U)) >> 8); }
+
+// 七种颜色，按 WS2812_Color 的 G R B W 顺序存放
 static const WS2812_Color colors[] = {
-    {255, 0, 0},    // 红
-    {255, 255, 0},  // 黄
-    {0, 255, 0},    // 绿
-    {0, 255, 255},  // 青
-    {0, 0, 255},    // 蓝
-    {255, 0, 255},  // 紫
-    {255, 255, 255} // 白
+    {0, 255, 0, 0},    // 红
+    {255, 255, 0, 0},  // 黄
+    {255, 0, 0, 0},    // 绿
+    {255, 0, 255, 0},  // 青
+    {0, 0, 255, 0},    // 蓝
+    {0, 255, 255, 0},  // 紫
+    {255, 255, 255, 0} // 白
 };
 
 #endif
\ No newline at end of file
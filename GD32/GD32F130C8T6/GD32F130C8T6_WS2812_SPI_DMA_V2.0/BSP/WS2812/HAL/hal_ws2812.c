@@ -1,22 +1,775 @@
 /* hal_ws2812.c */
 #include "hal_ws2812.h"
 #include "ll_ws2812.h"
+#include <string.h>
 
-WS2812_Status HAL_WS2812_Init(void)
+#if WS2812_STREAM_MODE
+// 乒乓缓冲区：DMA 循环读取，半传输/全传输中断里补填空闲的一半；
+// 按最大每灯槽位数分配，实际半区长度随灯带颜色顺序（24 / 32 bit）变化
+static WS2812_Slot stream_ring[2 * WS2812_STREAM_LEDS_PER_HALF * WS2812_BITS_PER_LED] __attribute__((aligned(4)));
+
+static struct
+{
+    const WS2812_Color *pixels;
+    WS2812_PixelSource source; // 非 NULL 时像素由回调边发边取，不经过 pixels
+    uint16_t count;
+    uint16_t half_slots; // 每个半区的槽位数
+    uint16_t next;       // 下一个待编码的灯
+    uint16_t zeros[2];   // 每个半区中数据结束后的零槽位数
+    uint32_t zero_done;  // 已发送完的尾部零槽位
+    uint32_t late;       // 补填时 DMA 已追上本半区的次数
+    uint32_t underrun;   // 像素源没跟上、帧被提前结束的次数
+    volatile uint8_t active;
+} stream;
+#endif
+
+// 当前灯带实际长度，不超过 WS2812_LED_POOL
+static uint16_t hal_led_count = WS2812_LED_NUM;
+
+// 灯带颜色顺序对应的编码函数和每灯槽位数
+static WS2812_EncodeRunFn hal_encode;
+static uint8_t hal_led_bits = 24;
+
+// 按当前主频和协议换算出的定时器周期、0/1 码比较值
+static WS2812_Timing hal_timing;
+// 每帧末尾实际发送的复位槽位数
+static uint16_t hal_reset_slots = WS2812_RESET_FRAMES * WS2812_BITS_PER_LED;
+
+#define HAL_BYTE_BACKEND (WS2812_SPI_BACKEND || WS2812_USART_BACKEND)
+#if HAL_BYTE_BACKEND
+// 当前输出方式；字节流后端（SPI / USART）的波形按字节存放在同一个 WS2812_Buffer 里
+static uint8_t hal_backend = WS2812_BACKEND_TIMER;
+static WS2812_PackFn hal_pack;
+static WS2812_ByteEncodeFn hal_byte_encode;
+static uint8_t hal_led_bytes;     // 每灯字节数
+static uint16_t hal_reset_bytes;  // 缓冲区中跟在数据后面的复位字节数
+#endif
+#if HAL_BYTE_BACKEND
+#define HAL_TIMER_BACKEND() (hal_backend == WS2812_BACKEND_TIMER)
+#else
+#define HAL_TIMER_BACKEND() 1
+#endif
+
+#if WS2812_TIMER_LATCH
+// 锁存周期的 ARR；phase：0 = 空闲或发送中，1 = 数据已写完、等 0 槽位周期结束，2 = 锁存周期进行中
+static uint32_t hal_latch_arr;
+static volatile uint8_t hal_latch_phase;
+static volatile uint8_t hal_latch_armed; // 锁存期间已提交下一帧
+#endif
+#if WS2812_USART_BACKEND
+static uint16_t hal_usart_reset_bytes; // 复位段字节数，不占缓冲区
+static volatile uint8_t hal_usart_latching; // 0 = 数据段，1 = 复位段，2 = 复位段已全部移出
+#endif
+
+// 帧序号：submit 每提交一帧加 1，done 每发完一帧（含复位时间）加 1，均从 1 开始编号
+static uint32_t hal_submit_seq;
+static volatile uint32_t hal_done_seq;
+static WS2812_FrameCallback hal_frame_cb;
+
+static void HAL_WS2812_FrameComplete(void)
+{
+    uint32_t seq = hal_done_seq + 1;
+    hal_done_seq = seq;
+    if (hal_frame_cb != NULL)
+        hal_frame_cb(seq);
+}
+
+#if WS2812_DOUBLE_BUFFER
+// front：DMA 正在发送的缓冲；pending：已排队、等传输完成中断切换过去的缓冲
+static WS2812_Buffer *volatile hal_front;
+static WS2812_Buffer *volatile hal_pending;
+static uint16_t hal_pending_len;
+#endif
+
+#if (WS2812_LANES > 1)
+#if WS2812_STREAM_MODE || WS2812_DOUBLE_BUFFER
+#error "多路 / GPIO 并行不支持流式 / 双缓冲模式"
+#endif
+#if (WS2812_MULTI_LANES > 1) && (WS2812_GPIO_LANES > 1)
+#error "WS2812_MULTI_LANES 与 WS2812_GPIO_LANES 不能同时打开"
+#endif
+#if (WS2812_MULTI_FIRST_CH + WS2812_MULTI_LANES > 4)
+#error "TIMER1 只有 CH0 ~ CH3"
+#endif
+#define HAL_LANES WS2812_LANES
+
+// 每路的灯数、在逻辑灯带中的起始下标、编码函数（GPIO 并行为取字函数）、每灯槽位数
+static struct
+{
+    uint16_t count;
+    uint16_t start;
+#if (WS2812_GPIO_LANES > 1)
+    WS2812_PackFn pack;
+#else
+    WS2812_EncodeRunFn encode;
+#endif
+    uint8_t bits;
+} hal_lane[HAL_LANES];
+static uint16_t hal_rows; // 一帧的槽位行数：各路中最长的数据 + 复位（GPIO 并行不含复位）
+#endif
+
+// 由协议最短复位 bit 数确定每帧实际发送的复位长度
+static WS2812_Status HAL_WS2812_SetupReset(uint16_t min_slots)
 {
+#if WS2812_MIN_LATCH
+    hal_reset_slots = min_slots;
+#else
+    // 整行发送复位，默认 WS2812_RESET_FRAMES 行，不够协议要求时按行加长
+    hal_reset_slots = WS2812_RESET_FRAMES * WS2812_BITS_PER_LED;
+    while (hal_reset_slots < min_slots)
+        hal_reset_slots += WS2812_BITS_PER_LED;
+#endif
+#if !WS2812_TIMER_LATCH
+    // 定时器锁存时复位不占缓冲区；字节流后端的复位字节在各自的 Setup 里按字节数检查
+    if (hal_reset_slots > WS2812_RESET_ROWS_MAX * WS2812_BITS_PER_LED)
+        return WS2812_ERR_INVALID_PARAM;
+#endif
+    return WS2812_OK;
+}
+
+// 按协议计算定时器周期、0/1 码比较值和复位长度
+static WS2812_Status HAL_WS2812_SetupTiming(uint8_t protocol)
+{
+    WS2812_Status st;
+
+    if (protocol >= WS2812_PROTO_NUM)
+        return WS2812_ERR_INVALID_PARAM;
+
+    // TIMER1 挂在 APB1 上，system_gd32f1x0.c 的各时钟选项中 APB1 均不分频，定时器时钟即 SystemCoreClock
+    st = WS2812_TimingCalc(SystemCoreClock, &ws2812_protocols[protocol], &hal_timing);
+    if (st != WS2812_OK)
+        return st;
+
+    st = HAL_WS2812_SetupReset(hal_timing.reset_slots);
+    if (st != WS2812_OK)
+        return st;
+#if (WS2812_DMA_WIDTH == 8) && !(WS2812_GPIO_LANES > 1)
+    if (hal_timing.t1h > 0xFF) // 8 位槽位放不下当前比较值
+        return WS2812_ERR_INVALID_PARAM;
+#endif
+#if WS2812_TIMER_LATCH
+    // 锁存不占缓冲区，直接按协议最短时间计时；数据后面的 0 槽位周期也算在内
+    uint32_t latch_slots = (hal_timing.reset_slots > 2) ? hal_timing.reset_slots - 1U : 1U;
+    hal_latch_arr = latch_slots * (hal_timing.arr + 1U) - 1U;
+#endif
+    HAL_WS2812_SetSlotLevels(hal_timing.t0h, hal_timing.t1h);
+    return WS2812_OK;
+}
+
+#if WS2812_SPI_BACKEND
+// 按协议选择 SPI 分频和每 bit 的 SPI 位数，复位长度换算成 0 字节
+static WS2812_Status HAL_WS2812_SetupSpi(uint8_t protocol)
+{
+    WS2812_SpiTiming spi;
+    WS2812_Status st;
+
+    if (protocol >= WS2812_PROTO_NUM)
+        return WS2812_ERR_INVALID_PARAM;
+
+    // SPI0 挂在 APB2 上，各时钟选项中 APB2 均不分频
+    st = WS2812_SpiTimingCalc(SystemCoreClock, &ws2812_protocols[protocol], &spi);
+    if (st != WS2812_OK)
+        return st;
+    st = HAL_WS2812_SetupReset(spi.reset_slots);
+    if (st != WS2812_OK)
+        return st;
+
+    hal_led_bytes = hal_led_bits * spi.sub_bits / 8U;
+    // DMA 传输完成时最后两个字节还在 SPI 数据和移位寄存器里，多补两个 0 字节
+    hal_reset_bytes = (uint16_t)((hal_reset_slots * spi.sub_bits + 7U) / 8U + 2U);
+    if ((uint32_t)WS2812_LED_POOL * hal_led_bytes + hal_reset_bytes > sizeof(((WS2812_Buffer *)0)->buffer))
+        return WS2812_ERR_INVALID_PARAM;
+    hal_byte_encode = HAL_WS2812_SpiEncode;
+    HAL_WS2812_SpiSetLevels(&spi);
+    LL_WS2812_SPI_Init(spi.psc_shift);
+    return WS2812_OK;
+}
+#endif
+
+#if WS2812_USART_BACKEND
+// 按协议选择 USART 波特率；复位段由 USART 计时、引脚保持低电平，不占缓冲区
+static WS2812_Status HAL_WS2812_SetupUsart(uint8_t protocol)
+{
+    WS2812_UsartTiming ut;
+    WS2812_Status st;
+
+    if (protocol >= WS2812_PROTO_NUM)
+        return WS2812_ERR_INVALID_PARAM;
+
+    // USART1 挂在 APB1 上，各时钟选项中 APB1 均不分频
+    st = WS2812_UsartTimingCalc(SystemCoreClock, &ws2812_protocols[protocol], &ut);
+    if (st != WS2812_OK)
+        return st;
+    st = HAL_WS2812_SetupReset(ut.reset_slots);
+    if (st != WS2812_OK)
+        return st;
+
+    hal_led_bytes = hal_led_bits / 2U;
+    hal_reset_bytes = 0;
+    hal_usart_reset_bytes = (uint16_t)((hal_reset_slots + 1U) / 2U);
+    hal_byte_encode = HAL_WS2812_UsartEncode;
+    HAL_WS2812_UsartSetLevels(&ut);
+    LL_WS2812_USART_Init(SystemCoreClock / ut.clocks);
+    return WS2812_OK;
+}
+
+// 由 USART 发送完成中断调用：数据段已全部移出则切到复位段，复位段已全部移出则一帧结束
+void HAL_WS2812_UsartIdle(void)
+{
+    if (hal_usart_latching == 0)
+    {
+        hal_usart_latching = 1;
+        LL_WS2812_USART_StartReset(hal_usart_reset_bytes);
+        return;
+    }
+    hal_usart_latching = 2;
+    HAL_WS2812_TransferComplete();
+}
+#endif
+
+#if (WS2812_LANES == 1)
+// 复位部分清零，返回整帧 DMA 传输次数
+static uint16_t HAL_WS2812_PrepareFrame(WS2812_Buffer *buffer)
+{
+#if HAL_BYTE_BACKEND
+    if (hal_backend != WS2812_BACKEND_TIMER)
+    {
+        uint16_t data = hal_led_count * hal_led_bytes;
+        memset((uint8_t *)buffer->buffer + data, 0, hal_reset_bytes);
+        return data + hal_reset_bytes;
+    }
+#endif
+#if WS2812_TIMER_LATCH
+    // 数据后只跟一个 0 槽位，保证最后一个 bit 完整输出后比较值归 0，其余锁存时间由定时器计时
+    buffer->buffer[hal_led_count * hal_led_bits] = 0;
+    return hal_led_count * hal_led_bits + 1U;
+#else
+    // 复位帧紧跟在有效灯之后，位置随灯数变化，发送前清零；DMA 长度只覆盖有效部分
+    memset(&buffer->buffer[hal_led_count * hal_led_bits], 0, sizeof(WS2812_Slot) * hal_reset_slots);
+    return hal_led_count * hal_led_bits + hal_reset_slots;
+#endif
+}
+
+static void HAL_WS2812_Start(const WS2812_Buffer *buffer, uint16_t len)
+{
+#if WS2812_SPI_BACKEND
+    if (hal_backend == WS2812_BACKEND_SPI)
+    {
+        LL_WS2812_SPI_StartTransfer(buffer->buffer, len);
+        return;
+    }
+#endif
+#if WS2812_USART_BACKEND
+    if (hal_backend == WS2812_BACKEND_USART)
+    {
+        hal_usart_latching = 0;
+        LL_WS2812_USART_StartTransfer(buffer->buffer, len);
+        return;
+    }
+#endif
+    LL_WS2812_StartTransfer(buffer->buffer, len);
+}
+#endif
+
+#if (WS2812_LANES > 1)
+/**
+ * @brief 初始化多路灯带
+ * @param cfg WS2812_LANES 个配置组成的数组，依次对应 CH(WS2812_MULTI_FIRST_CH) 起的各通道，GPIO 并行时对应 PB0 起的各引脚；
+ *            各路协议必须相同，灯数不超过 WS2812_LANE_LED_POOL；GPIO 并行时各路每灯位数（RGB / RGBW）也必须相同
+ */
+WS2812_Status HAL_WS2812_Init(const WS2812_StripConfig *cfg)
+{
+    WS2812_Status st;
+    uint16_t start = 0, slots = 0;
+
+    if (cfg == NULL)
+        return WS2812_ERR_INVALID_PARAM;
+    for (uint8_t l = 0; l < HAL_LANES; l++)
+    {
+        if (cfg[l].backend != WS2812_BACKEND_TIMER)
+            return WS2812_ERR_INVALID_PARAM;
+        if (cfg[l].protocol != cfg[0].protocol || cfg[l].led_count == 0 || cfg[l].led_count > WS2812_LANE_LED_POOL)
+            return WS2812_ERR_INVALID_PARAM;
+#if (WS2812_GPIO_LANES > 1)
+        // 各路的同一 bit 在一个字节里同时发出，每灯位数必须一致
+        hal_lane[l].pack = HAL_WS2812_GetPacker(cfg[l].order, &hal_lane[l].bits);
+        if (hal_lane[l].pack == NULL || hal_lane[l].bits != hal_lane[0].bits)
+            return WS2812_ERR_INVALID_PARAM;
+#else
+        hal_lane[l].encode = HAL_WS2812_GetEncoder(cfg[l].order, &hal_lane[l].bits);
+        if (hal_lane[l].encode == NULL)
+            return WS2812_ERR_INVALID_PARAM;
+#endif
+        hal_lane[l].count = cfg[l].led_count;
+        hal_lane[l].start = start;
+        start += cfg[l].led_count;
+        if (cfg[l].led_count * hal_lane[l].bits > slots)
+            slots = cfg[l].led_count * hal_lane[l].bits;
+    }
+
+    st = HAL_WS2812_SetupTiming(cfg[0].protocol);
+    if (st != WS2812_OK)
+        return st;
+    hal_led_count = start;
+
+#if (WS2812_GPIO_LANES > 1)
+    hal_led_bits = hal_lane[0].bits;
+    hal_rows = slots;
+    LL_WS2812_ParallelInit(HAL_LANES, hal_timing.arr, hal_timing.t0h, hal_timing.t1h);
+#else
+    hal_rows = slots + hal_reset_slots;
+    LL_WS2812_TIMER_DMA_Init(hal_timing.arr);
+    LL_WS2812_DMA_Init();
+    LL_WS2812_BurstInit(WS2812_MULTI_FIRST_CH, HAL_LANES);
+#endif
+    return WS2812_OK;
+}
+#else
+/**
+ * @brief 初始化灯带
+ * @param cfg 灯数、协议时序、颜色顺序、输出方式
+ */
+WS2812_Status HAL_WS2812_Init(const WS2812_StripConfig *cfg)
+{
+    WS2812_Status st;
+
+    if (cfg == NULL)
+        return WS2812_ERR_INVALID_PARAM;
+#if HAL_BYTE_BACKEND
+    if (cfg->backend != WS2812_BACKEND_TIMER)
+    {
+#if WS2812_STREAM_MODE
+        // 流式补填按比较值槽位计算半区，字节流后端不支持
+        return WS2812_ERR_INVALID_PARAM;
+#endif
+        hal_pack = HAL_WS2812_GetPacker(cfg->order, &hal_led_bits);
+        if (hal_pack == NULL)
+            return WS2812_ERR_INVALID_PARAM;
+        st = HAL_WS2812_SetLedCount(cfg->led_count);
+        if (st != WS2812_OK)
+            return st;
+        switch (cfg->backend)
+        {
+#if WS2812_SPI_BACKEND
+        case WS2812_BACKEND_SPI:
+            st = HAL_WS2812_SetupSpi(cfg->protocol);
+            break;
+#endif
+#if WS2812_USART_BACKEND
+        case WS2812_BACKEND_USART:
+            st = HAL_WS2812_SetupUsart(cfg->protocol);
+            break;
+#endif
+        default:
+            st = WS2812_ERR_INVALID_PARAM;
+            break;
+        }
+        if (st != WS2812_OK)
+            return st;
+        hal_backend = cfg->backend;
+        return WS2812_OK;
+    }
+#endif
+    if (cfg->backend != WS2812_BACKEND_TIMER)
+        return WS2812_ERR_INVALID_PARAM;
+#if WS2812_STREAM_MODE
+    if (!HAL_WS2812_StreamClockOk(SystemCoreClock))
+        return WS2812_ERR_INVALID_PARAM;
+#endif
+    // 未编译的颜色顺序（如关闭 WS2812_RGBW 时的 RGBW）返回 NULL
+    hal_encode = HAL_WS2812_GetEncoder(cfg->order, &hal_led_bits);
+    if (hal_encode == NULL)
+        return WS2812_ERR_INVALID_PARAM;
+    st = HAL_WS2812_SetLedCount(cfg->led_count);
+    if (st != WS2812_OK)
+        return st;
+    st = HAL_WS2812_SetupTiming(cfg->protocol);
+    if (st != WS2812_OK)
+        return st;
+
     LL_WS2812_GPIO_Init();
-    LL_WS2812_TIMER_DMA_Init();
+    LL_WS2812_TIMER_DMA_Init(hal_timing.arr);
+    LL_WS2812_DMA_Init();
     return WS2812_OK;
 }
+#endif
 
 WS2812_Status HAL_WS2812_SendFrame(WS2812_Buffer *buffer)
 {
+#if WS2812_DOUBLE_BUFFER
+    if (hal_pending != NULL)
+        return WS2812_ERR_DMA_BUSY;
+
+    uint16_t len = HAL_WS2812_PrepareFrame(buffer);
+
+    // 检查 front 和排队之间不能被传输完成中断打断，否则会丢帧
+    __disable_irq();
+    hal_submit_seq++;
+    if (hal_front == NULL)
+    {
+        hal_front = buffer;
+        HAL_WS2812_Start(buffer, len);
+    }
+    else
+    {
+        hal_pending_len = len;
+        hal_pending = buffer;
+    }
+    __enable_irq();
+#else
     if (LL_WS2812_IsDMABusy())
         return WS2812_ERR_DMA_BUSY;
 
-    LL_WS2812_StartTransfer(&buffer->buffer[0][0], WS2812_LED_NUM * WS2812_BITS_PER_LED + WS2812_RESET_FRAMES * WS2812_BITS_PER_LED);
+#if (WS2812_GPIO_LANES > 1)
+    // 复位期间置位通道已停，引脚保持低电平，缓冲区里不需要复位槽位
+    hal_submit_seq++;
+    LL_WS2812_ParallelStart(buffer->buffer, hal_rows, hal_rows + hal_reset_slots);
+#elif (WS2812_MULTI_LANES > 1)
+    // 各路数据结束后一直补零到帧尾，较短的灯带复位时间更长
+    for (uint8_t l = 0; l < HAL_LANES; l++)
+    {
+        for (uint16_t row = hal_lane[l].count * hal_lane[l].bits; row < hal_rows; row++)
+            buffer->buffer[row * HAL_LANES + l] = 0;
+    }
+    hal_submit_seq++;
+    LL_WS2812_StartTransfer(buffer->buffer, hal_rows * HAL_LANES);
+#else
+    uint16_t len = HAL_WS2812_PrepareFrame(buffer);
+#if WS2812_TIMER_LATCH
+    // 上一帧还在锁存：配好 DMA 等锁存结束的更新事件，锁存周期已开始时立即打开更新请求，
+    // 否则由 0 槽位周期结束时的更新中断打开；判断和配置之间不能被定时器中断打断
+    __disable_irq();
+    if (hal_latch_phase != 0)
+    {
+        hal_submit_seq++;
+        hal_latch_armed = 1;
+        LL_WS2812_LatchArm(buffer->buffer, len);
+        if (hal_latch_phase == 2)
+            LL_WS2812_LatchRelease();
+        __enable_irq();
+        return WS2812_OK;
+    }
+    __enable_irq();
+#endif
+    hal_submit_seq++;
+    HAL_WS2812_Start(buffer, len);
+#endif
+#endif
+
+    return WS2812_OK;
+}
+
+// 由 DMA 传输完成中断调用，此时最后一个复位槽位已装入比较寄存器，
+// 前面的复位槽位已经输出完，灯已锁存
+void HAL_WS2812_TransferComplete(void)
+{
+#if WS2812_USART_BACKEND
+    // USART 后端分两段，每段 DMA 完成时最后一两个字节还在移位，都要等发送完成中断：
+    // 数据段之后切到复位段；复位段之后才结束本帧，否则复位变短，下一帧切回 USART 时起始位会输出到灯带
+    if (hal_backend == WS2812_BACKEND_USART && hal_usart_latching != 2)
+    {
+        LL_WS2812_USART_WaitIdle();
+        return;
+    }
+#endif
+#if WS2812_TIMER_LATCH
+    // 0 槽位已装入比较寄存器，最后一个 bit 正常结束；帧完成推迟到锁存计时结束
+    if (HAL_TIMER_BACKEND())
+    {
+        hal_latch_phase = 1;
+        LL_WS2812_LatchBegin(hal_latch_arr);
+        return;
+    }
+#endif
+    HAL_WS2812_FrameComplete();
+#if WS2812_DOUBLE_BUFFER
+    WS2812_Buffer *next = hal_pending;
+    if (next != NULL)
+    {
+        // 定时器不停，只把 DMA 内存地址指向排队的缓冲，下一个更新事件接着发新帧
+        hal_pending = NULL;
+        hal_front = next;
+        HAL_WS2812_Start(next, hal_pending_len);
+        return;
+    }
+    hal_front = NULL;
+#endif
+#if WS2812_SPI_BACKEND
+    if (hal_backend == WS2812_BACKEND_SPI)
+    {
+        LL_WS2812_SPI_StopTransfer();
+        return;
+    }
+#endif
+#if WS2812_USART_BACKEND
+    if (hal_backend == WS2812_BACKEND_USART)
+    {
+        LL_WS2812_USART_StopTransfer();
+        return;
+    }
+#endif
+    LL_WS2812_StopTransfer();
+}
+
+#if WS2812_TIMER_LATCH
+// 由 TIMER1 更新中断调用：第一次为锁存周期开始，第二次为锁存结束
+void HAL_WS2812_LatchTick(void)
+{
+    if (hal_latch_phase == 1)
+    {
+        hal_latch_phase = 2;
+        LL_WS2812_LatchRestore(hal_timing.arr);
+        if (hal_latch_armed)
+            LL_WS2812_LatchRelease();
+        return;
+    }
+
+    // 有下一帧时定时器不停，本次更新事件已把它的第一个槽位写入比较寄存器
+    hal_latch_phase = 0;
+    LL_WS2812_LatchEnd(hal_latch_armed);
+    hal_latch_armed = 0;
+    HAL_WS2812_FrameComplete();
+}
+#endif
+
+#if WS2812_DOUBLE_BUFFER
+// 有缓冲在排队时，另一份缓冲仍在发送，不能编码新帧
+uint8_t HAL_WS2812_SwapPending(void) { return hal_pending != NULL; }
+#endif
+
+// 运行中修改灯数，只能在空闲时进行，下一帧起生效
+WS2812_Status HAL_WS2812_SetLedCount(uint16_t led_count)
+{
+#if (WS2812_LANES > 1)
+    // 多路模式下各路灯数在初始化时确定
+    (void)led_count;
+    return WS2812_ERR_INVALID_PARAM;
+#else
+    if (led_count == 0 || led_count > WS2812_LED_POOL)
+        return WS2812_ERR_INVALID_PARAM;
+    if (HAL_WS2812_IsBusy())
+        return WS2812_ERR_DMA_BUSY;
+
+    hal_led_count = led_count;
+    return WS2812_OK;
+#endif
+}
+
+uint16_t HAL_WS2812_GetLedCount(void) { return hal_led_count; }
+
+const WS2812_Timing *HAL_WS2812_GetTiming(void) { return &hal_timing; }
+
+// 注册帧完成回调，传 NULL 取消；回调运行在中断里，应尽量短
+void HAL_WS2812_SetFrameCallback(WS2812_FrameCallback cb) { hal_frame_cb = cb; }
+
+// 最近一次提交的帧序号，可作为栅栏交给 HAL_WS2812_WaitFrame
+uint32_t HAL_WS2812_GetSubmitSeq(void) { return hal_submit_seq; }
+
+// 已发送完成的帧序号
+uint32_t HAL_WS2812_GetDoneSeq(void) { return hal_done_seq; }
+
+// 序号 seq 的帧是否已发完，用有符号差值比较，序号回绕后仍然正确
+uint8_t HAL_WS2812_IsFrameDone(uint32_t seq) { return (int32_t)(hal_done_seq - seq) >= 0; }
+
+// 等待序号 seq 的帧发完，期间 WFI 休眠，由 DMA 中断（或 SysTick）唤醒
+void HAL_WS2812_WaitFrame(uint32_t seq)
+{
+    // 还没提交的帧永远等不到
+    if ((int32_t)(seq - hal_submit_seq) > 0)
+        return;
+    while (!HAL_WS2812_IsFrameDone(seq))
+        __WFI();
+}
+
+uint8_t HAL_WS2812_IsBusy(void)
+{
+#if WS2812_STREAM_MODE
+    return stream.active;
+#elif WS2812_DOUBLE_BUFFER
+    return hal_front != NULL;
+#else
+    return LL_WS2812_IsDMABusy();
+#endif
+}
+
+#if (WS2812_GPIO_LANES > 1)
+// 把各路第 pos 个灯一起编码成 hal_led_bits 个位平面字节；比该路灯数长的位置按黑色发送
+static void HAL_WS2812_EncodePlanes(WS2812_Buffer *buffer, const WS2812_Color *pixels, uint16_t pos)
+{
+    uint32_t word[HAL_LANES];
+    WS2812_Slot *dst = &buffer->buffer[pos * hal_led_bits];
+    const uint8_t mask = (uint8_t)((1U << HAL_LANES) - 1U);
+
+    for (uint8_t l = 0; l < HAL_LANES; l++)
+        word[l] = (pos < hal_lane[l].count) ? hal_lane[l].pack(&pixels[hal_lane[l].start + pos]) : 0;
+
+    for (int8_t shift = hal_led_bits - 8; shift >= 0; shift -= 8, dst += 8)
+    {
+        uint32_t lo = 0, hi = 0;
+
+        for (uint8_t l = 0; l < HAL_LANES; l++)
+        {
+            uint32_t byte = (word[l] >> shift) & 0xFFU;
+            if (l < 4)
+                lo |= byte << (8 * l);
+            else
+                hi |= byte << (8 * (l - 4));
+        }
+        HAL_WS2812_Transpose8(lo, hi, dst);
 
+        // 写 BC 寄存器：为 1 的路在 t0h 处拉低，即发送 0 码
+        for (uint8_t k = 0; k < 8; k++)
+            dst[k] = (uint8_t)(~dst[k] & mask);
+    }
+}
+#endif
+
+// 把像素帧缓冲中 [first, first + count) 的灯编码进波形缓冲区
+void HAL_WS2812_Encode(WS2812_Buffer *buffer, const WS2812_Color *pixels, uint16_t first, uint16_t count)
+{
+#if (WS2812_GPIO_LANES > 1)
+    // 同一位置上各路的灯一起转置：整帧编码时每个位置只处理一次，
+    // 局部更新时逐灯处理，同一位置的多路都变化时会重复转置，结果不变
+    if (first == 0 && count == hal_led_count)
+    {
+        for (uint16_t pos = 0; pos < hal_rows / hal_led_bits; pos++)
+            HAL_WS2812_EncodePlanes(buffer, pixels, pos);
+        return;
+    }
+
+    uint8_t l = 0;
+    for (uint16_t i = first; i < first + count; i++)
+    {
+        while (i >= hal_lane[l].start + hal_lane[l].count)
+            l++;
+        HAL_WS2812_EncodePlanes(buffer, pixels, i - hal_lane[l].start);
+    }
+#elif (WS2812_MULTI_LANES > 1)
+    // 逐灯编码到临时区，再按 [槽位][通道] 交织写入
+    WS2812_Slot tmp[WS2812_BITS_PER_LED] __attribute__((aligned(4)));
+    uint8_t l = 0;
+
+    for (uint16_t i = first; i < first + count; i++)
+    {
+        while (i >= hal_lane[l].start + hal_lane[l].count)
+            l++;
+        hal_lane[l].encode(tmp, &pixels[i], 1);
+
+        WS2812_Slot *dst = &buffer->buffer[(i - hal_lane[l].start) * hal_lane[l].bits * HAL_LANES + l];
+        for (uint8_t k = 0; k < hal_lane[l].bits; k++)
+            dst[k * HAL_LANES] = tmp[k];
+    }
+#else
+#if HAL_BYTE_BACKEND
+    if (hal_backend != WS2812_BACKEND_TIMER)
+    {
+        hal_byte_encode((uint8_t *)buffer->buffer + first * hal_led_bytes, hal_pack, hal_led_bits, &pixels[first],
+                        count);
+        return;
+    }
+#endif
+    hal_encode(&buffer->buffer[first * hal_led_bits], &pixels[first], count);
+#endif
+}
+
+#if WS2812_STREAM_MODE
+static void HAL_WS2812_StreamFill(uint8_t half)
+{
+    WS2812_Slot *slot = &stream_ring[half * stream.half_slots];
+    uint16_t n = stream.count - stream.next;
+
+    if (n > WS2812_STREAM_LEDS_PER_HALF)
+        n = WS2812_STREAM_LEDS_PER_HALF;
+    if (n > 0 && stream.source != NULL)
+    {
+        WS2812_Color px[WS2812_STREAM_LEDS_PER_HALF];
+        uint16_t got = stream.source(px, n);
+
+        // 线上不能停顿等数据，停顿超过复位时间灯带就会锁存；直接结束本帧，后面补零即复位
+        if (got < n)
+        {
+            stream.underrun++;
+            stream.count = stream.next + got;
+            n = got;
+        }
+        if (n > 0)
+            hal_encode(slot, px, n);
+        stream.next += n;
+    }
+    else if (n > 0)
+    {
+        hal_encode(slot, &stream.pixels[stream.next], n);
+        stream.next += n;
+    }
+
+    // 数据发完后补零槽位，比较值 0 即整周期低电平，用作复位
+    stream.zeros[half] = stream.half_slots - n * hal_led_bits;
+    memset(slot + n * hal_led_bits, 0, stream.zeros[half] * sizeof(WS2812_Slot));
+}
+
+static WS2812_Status HAL_WS2812_StreamStart(const WS2812_Color *pixels, WS2812_PixelSource source, uint16_t count)
+{
+    if (stream.active)
+        return WS2812_ERR_DMA_BUSY;
+
+    stream.pixels = pixels;
+    stream.source = source;
+    stream.count = count;
+    stream.half_slots = WS2812_STREAM_LEDS_PER_HALF * hal_led_bits;
+    stream.next = 0;
+    stream.zero_done = 0;
+    HAL_WS2812_StreamFill(0);
+    HAL_WS2812_StreamFill(1);
+
+    stream.active = 1;
+    hal_submit_seq++;
+    LL_WS2812_StartCircular(stream_ring, 2 * stream.half_slots);
     return WS2812_OK;
 }
 
-uint8_t HAL_WS2812_IsBusy(void) { return LL_WS2812_IsDMABusy(); }
\ No newline at end of file
+WS2812_Status HAL_WS2812_SendStream(const WS2812_Color *pixels, uint16_t count)
+{
+    return HAL_WS2812_StreamStart(pixels, NULL, count);
+}
+
+// 由 DMA 中断调用：half 为刚被 DMA 读完的半区，此时 DMA 正在读另一半
+void HAL_WS2812_StreamRefill(uint8_t half)
+{
+    if (!stream.active)
+        return;
+
+    // 尾部零槽位累计够复位时间后停止，输出保持低电平
+    stream.zero_done += stream.zeros[half];
+    if (stream.zero_done >= hal_reset_slots)
+    {
+        LL_WS2812_StopTransfer();
+        stream.active = 0;
+        HAL_WS2812_FrameComplete();
+        return;
+    }
+
+    HAL_WS2812_StreamFill(half);
+
+    // 剩余计数 > 半区长度说明 DMA 在前半区，<= 则在后半区
+    uint32_t remaining = LL_WS2812_GetRemaining();
+    if ((half == 0) ? (remaining > stream.half_slots) : (remaining <= stream.half_slots))
+        stream.late++;
+}
+
+/**
+ * @brief 流式发送，像素由回调在 DMA 中断里按需取，不需要整帧的像素数组
+ * @param source 像素源，第一次在本函数里调用，之后在 DMA 中断里调用
+ * @param count 本帧灯数
+ * @note 像素源返回少于请求的数量时本帧提前结束，计入 HAL_WS2812_StreamUnderrunCount()
+ */
+WS2812_Status HAL_WS2812_SendStreamFrom(WS2812_PixelSource source, uint16_t count)
+{
+    if (source == NULL)
+        return WS2812_ERR_INVALID_PARAM;
+    return HAL_WS2812_StreamStart(NULL, source, count);
+}
+
+uint32_t HAL_WS2812_StreamLateCount(void) { return stream.late; }
+
+uint32_t HAL_WS2812_StreamUnderrunCount(void) { return stream.underrun; }
+#endif
@@ -3,21 +3,138 @@
 #define HAL_WS2812_H
 
 #include "ws2812_common.h" // 只依赖公共类型
+#include "hal_ws2812_timing.h"
 #include <stdint.h>
 
-// 前向声明避免包含驱动层头文件
-#define WS2812_LED_NUM 30
-#define WS2812_BITS_PER_LED 24
-#define WS2812_RESET_FRAMES 3
+// 单个 bit 对应的比较值槽位，宽度与 DMA 内存位宽一致；
+// GPIO 并行模式下槽位是各路同一 bit 组成的字节，第 l 位为 1 表示第 l 路在 0 码高电平结束时拉低
+#if (WS2812_GPIO_LANES > 1)
+typedef uint8_t WS2812_Slot;
+#elif (WS2812_DMA_WIDTH == 32)
+typedef uint32_t WS2812_Slot;
+#elif (WS2812_DMA_WIDTH == 16)
+typedef uint16_t WS2812_Slot;
+#elif (WS2812_DMA_WIDTH == 8)
+typedef uint8_t WS2812_Slot;
+#else
+#error "WS2812_DMA_WIDTH 只支持 8 / 16 / 32"
+#endif
 
+#if (WS2812_MULTI_LANES > 1)
+#define WS2812_BUFFER_SLOTS (WS2812_MULTI_LANES * (WS2812_MULTI_LED_POOL + WS2812_RESET_ROWS_MAX) * WS2812_BITS_PER_LED)
+#if (WS2812_BUFFER_SLOTS * (WS2812_DMA_WIDTH / 8) > 4096)
+#error "多路波形缓冲区 RAM 不足，请减小 WS2812_MULTI_LED_POOL 或 WS2812_DMA_WIDTH"
+#endif
+#elif (WS2812_GPIO_LANES > 1)
+#if (WS2812_GPIO_LANES > 8)
+#error "GPIO 并行最多 8 路（PB0 ~ PB7）"
+#endif
+// 复位期间不再写数据，缓冲区只存有效位
+#define WS2812_BUFFER_SLOTS (WS2812_GPIO_LED_POOL * WS2812_BITS_PER_LED)
+// 帧缓冲每灯 4 字节，8 KB RAM 中留给它的不超过 4 KB
+#if (WS2812_LED_POOL * 4 > 4096)
+#error "GPIO 并行帧缓冲 RAM 不足，请减小 WS2812_GPIO_LED_POOL"
+#endif
+#else
+// 定时器锁存时数据后面只跟一个 0 槽位
+#define WS2812_BUFFER_SLOTS (RGB_ARRAY_SIZE * WS2812_BITS_PER_LED + WS2812_TIMER_LATCH)
+#endif
+
+typedef struct
+{
+        // 按槽位连续存放，每灯占的槽位数（24 / 32）由灯带的颜色顺序决定；多路时按 [槽位][通道] 交织，
+        // GPIO 并行时每个槽位已包含全部各路
+        WS2812_Slot buffer[WS2812_BUFFER_SLOTS];
+} __attribute__((aligned(4))) WS2812_Buffer;
+
+// 灯带配置，多路 / GPIO 并行模式下 HAL_WS2812_Init 接收 WS2812_LANES 个配置组成的数组
 typedef struct
 {
-        uint32_t buffer[WS2812_LED_NUM + WS2812_RESET_FRAMES][WS2812_BITS_PER_LED];
-} WS2812_Buffer;
+    uint16_t led_count; // 灯数，1 ~ WS2812_LED_POOL
+    uint8_t protocol;   // 协议时序，WS2812_PROTO_xxx
+    uint8_t order;      // 颜色顺序，WS2812_ORDER_xxx
+    uint8_t backend;    // 输出方式，WS2812_BACKEND_xxx；多路 / GPIO 并行时只能为 TIMER
+} WS2812_StripConfig;
+
+// 连续编码 n 个像素，每种颜色顺序一个专用实现
+typedef void (*WS2812_EncodeRunFn)(WS2812_Slot *slot, const WS2812_Color *c, uint16_t n);
+// 按颜色顺序拼出一个像素的 24 / 32 位数据，高位先发
+typedef uint32_t (*WS2812_PackFn)(const WS2812_Color *c);
+
+#if WS2812_DOUBLE_BUFFER
+#if WS2812_STREAM_MODE
+#error "双缓冲与流式模式不能同时打开"
+#endif
+// 8 KB RAM 里还要放栈、堆和帧缓冲，两份波形缓冲区合计不超过 4 KB
+#if (2 * RGB_ARRAY_SIZE * WS2812_BITS_PER_LED * (WS2812_DMA_WIDTH / 8) > 4096)
+#error "双缓冲 RAM 不足，请减小 WS2812_LED_POOL 或 WS2812_DMA_WIDTH"
+#endif
+#endif
+
+// 帧完成回调，在 DMA 中断里调用，seq 为刚发完的帧序号
+typedef void (*WS2812_FrameCallback)(uint32_t seq);
 
 // HAL接口
-WS2812_Status HAL_WS2812_Init(void);
+WS2812_Status HAL_WS2812_Init(const WS2812_StripConfig *cfg);
+WS2812_Status HAL_WS2812_SetLedCount(uint16_t led_count);
+uint16_t HAL_WS2812_GetLedCount(void);
 WS2812_Status HAL_WS2812_SendFrame(WS2812_Buffer *buffer);
+const WS2812_Timing *HAL_WS2812_GetTiming(void);
+void HAL_WS2812_SetSlotLevels(uint16_t t0h, uint16_t t1h);
+void HAL_WS2812_EncodeSlots(WS2812_Slot *slot, uint32_t grb);
+WS2812_EncodeRunFn HAL_WS2812_GetEncoder(uint8_t order, uint8_t *bits);
+WS2812_PackFn HAL_WS2812_GetPacker(uint8_t order, uint8_t *bits);
+void HAL_WS2812_SetBrightness(uint8_t bri);
+uint8_t HAL_WS2812_GetBrightness(void);
+void HAL_WS2812_Encode(WS2812_Buffer *buffer, const WS2812_Color *pixels, uint16_t first, uint16_t count);
+void HAL_WS2812_Transpose8(uint32_t lo, uint32_t hi, uint8_t *out);
+
+#if WS2812_SPI_BACKEND || WS2812_USART_BACKEND
+// 字节流后端（SPI / USART）的连续编码函数，波形按字节存放在 WS2812_Buffer 里
+typedef void (*WS2812_ByteEncodeFn)(uint8_t *dst, WS2812_PackFn pack, uint8_t bits, const WS2812_Color *c, uint16_t n);
+#endif
+#if WS2812_SPI_BACKEND
+void HAL_WS2812_SpiSetLevels(const WS2812_SpiTiming *t);
+void HAL_WS2812_SpiEncode(uint8_t *dst, WS2812_PackFn pack, uint8_t bits, const WS2812_Color *c, uint16_t n);
+#endif
+#if WS2812_USART_BACKEND
+void HAL_WS2812_UsartSetLevels(const WS2812_UsartTiming *t);
+void HAL_WS2812_UsartEncode(uint8_t *dst, WS2812_PackFn pack, uint8_t bits, const WS2812_Color *c, uint16_t n);
+void HAL_WS2812_UsartIdle(void);
+#endif
+
+#if WS2812_ENCODE_BENCH
+void HAL_WS2812_EncodeSlotsWith(uint8_t encoder, WS2812_Slot *slot, uint32_t grb);
+#endif
+
+// 流式补填的中断预算：一个半区要容纳一次高优先级阻塞加补填，主频低于该值时不够用
+#define WS2812_STREAM_MIN_CLOCK 48000000U
+static inline uint8_t HAL_WS2812_StreamClockOk(uint32_t clock) { return clock >= WS2812_STREAM_MIN_CLOCK; }
+
+#if WS2812_STREAM_MODE
+// 流式发送：pixels 在发送结束前必须保持有效
+WS2812_Status HAL_WS2812_SendStream(const WS2812_Color *pixels, uint16_t count);
+// 像素源：在 DMA 中断里调用，最多取 max 个像素写进 out，返回实际取到的个数
+typedef uint16_t (*WS2812_PixelSource)(WS2812_Color *out, uint16_t max);
+WS2812_Status HAL_WS2812_SendStreamFrom(WS2812_PixelSource source, uint16_t count);
+void HAL_WS2812_StreamRefill(uint8_t half);
+uint32_t HAL_WS2812_StreamLateCount(void);
+uint32_t HAL_WS2812_StreamUnderrunCount(void);
+#endif
 uint8_t HAL_WS2812_IsBusy(void);
+void HAL_WS2812_SetFrameCallback(WS2812_FrameCallback cb);
+uint32_t HAL_WS2812_GetSubmitSeq(void);
+uint32_t HAL_WS2812_GetDoneSeq(void);
+uint8_t HAL_WS2812_IsFrameDone(uint32_t seq);
+void HAL_WS2812_WaitFrame(uint32_t seq);
+#if !WS2812_STREAM_MODE
+void HAL_WS2812_TransferComplete(void);
+#endif
+#if WS2812_DOUBLE_BUFFER
+uint8_t HAL_WS2812_SwapPending(void);
+#endif
+#if WS2812_TIMER_LATCH
+void HAL_WS2812_LatchTick(void);
+#endif
 
 #endif
\ No newline at end of file
@@ -0,0 +1,291 @@
+/* hal_ws2812_encode.c - 像素到比较值的位展开 */
+#include "hal_ws2812.h"
+#include <string.h>
+
+// 查表法不直接存比较值，而是存"每个槽位 0/1"的展开位图，
+// 再用一次乘加得到比较值：slot = bit * (T1H - T0H) + T0H。
+// 每个槽位都不超过 T1H，不会向相邻槽位进位，所以可以按整字计算、整字写入。
+// 表与时序无关，T0H/T1H 在初始化时按主频算出后再设置进来。
+#define WS2812_B(n, k) ((uint32_t)(((n) >> (k)) & 1U))
+#define WS2812_NIBBLE_WORDS (WS2812_DMA_WIDTH / 8) // 4 个槽位占的字数
+#define WS2812_SLOTS_PER_WORD (4 / (WS2812_DMA_WIDTH / 8))
+
+#if (WS2812_DMA_WIDTH == 8)
+#define WS2812_SLOT_REPEAT 0x01010101U
+#define WS2812_NIBBLE_W(n) (WS2812_B(n, 3) | WS2812_B(n, 2) << 8 | WS2812_B(n, 1) << 16 | WS2812_B(n, 0) << 24)
+#elif (WS2812_DMA_WIDTH == 16)
+#define WS2812_SLOT_REPEAT 0x00010001U
+#define WS2812_NIBBLE_W(n) (WS2812_B(n, 3) | WS2812_B(n, 2) << 16), (WS2812_B(n, 1) | WS2812_B(n, 0) << 16)
+#else
+#define WS2812_SLOT_REPEAT 0x00000001U
+#define WS2812_NIBBLE_W(n) WS2812_B(n, 3), WS2812_B(n, 2), WS2812_B(n, 1), WS2812_B(n, 0)
+#endif
+
+#if (WS2812_ENCODER == WS2812_ENCODER_NIBBLE) || WS2812_ENCODE_BENCH
+// 16 项 x 4 槽位，高位先发
+static const uint32_t ws2812_nibble_lut[16][WS2812_NIBBLE_WORDS] = {
+    {WS2812_NIBBLE_W(0)},  {WS2812_NIBBLE_W(1)},  {WS2812_NIBBLE_W(2)},  {WS2812_NIBBLE_W(3)},
+    {WS2812_NIBBLE_W(4)},  {WS2812_NIBBLE_W(5)},  {WS2812_NIBBLE_W(6)},  {WS2812_NIBBLE_W(7)},
+    {WS2812_NIBBLE_W(8)},  {WS2812_NIBBLE_W(9)},  {WS2812_NIBBLE_W(10)}, {WS2812_NIBBLE_W(11)},
+    {WS2812_NIBBLE_W(12)}, {WS2812_NIBBLE_W(13)}, {WS2812_NIBBLE_W(14)}, {WS2812_NIBBLE_W(15)},
+};
+#endif
+
+#if (WS2812_ENCODER == WS2812_ENCODER_BYTE) || WS2812_ENCODE_BENCH
+// 256 项 x 8 槽位，占 Flash 256 * 8 * WS2812_DMA_WIDTH / 8 字节
+#define WS2812_BYTE(v) {WS2812_NIBBLE_W((v) >> 4), WS2812_NIBBLE_W((v) & 0xF)}
+#define WS2812_BYTE4(v) WS2812_BYTE(v), WS2812_BYTE((v) + 1), WS2812_BYTE((v) + 2), WS2812_BYTE((v) + 3)
+#define WS2812_BYTE16(v) WS2812_BYTE4(v), WS2812_BYTE4((v) + 4), WS2812_BYTE4((v) + 8), WS2812_BYTE4((v) + 12)
+#define WS2812_BYTE64(v) WS2812_BYTE16(v), WS2812_BYTE16((v) + 16), WS2812_BYTE16((v) + 32), WS2812_BYTE16((v) + 48)
+
+static const uint32_t ws2812_byte_lut[256][2 * WS2812_NIBBLE_WORDS] = {
+    WS2812_BYTE64(0), WS2812_BYTE64(64), WS2812_BYTE64(128), WS2812_BYTE64(192),
+};
+#endif
+
+#if WS2812_GAMMA
+// gamma 2.2 校正表：out = round(255 * (in / 255) ^ 2.2)
+static const uint8_t ws2812_gamma_lut[256] = {
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   1,
+      1,   1,   1,   1,   1,   1,   1,   1,   1,   2,   2,   2,   2,   2,   2,   2,
+      3,   3,   3,   3,   3,   4,   4,   4,   4,   5,   5,   5,   5,   6,   6,   6,
+      6,   7,   7,   7,   8,   8,   8,   9,   9,   9,  10,  10,  11,  11,  11,  12,
+     12,  13,  13,  13,  14,  14,  15,  15,  16,  16,  17,  17,  18,  18,  19,  19,
+     20,  20,  21,  22,  22,  23,  23,  24,  25,  25,  26,  26,  27,  28,  28,  29,
+     30,  30,  31,  32,  33,  33,  34,  35,  35,  36,  37,  38,  39,  39,  40,  41,
+     42,  43,  43,  44,  45,  46,  47,  48,  49,  49,  50,  51,  52,  53,  54,  55,
+     56,  57,  58,  59,  60,  61,  62,  63,  64,  65,  66,  67,  68,  69,  70,  71,
+     73,  74,  75,  76,  77,  78,  79,  81,  82,  83,  84,  85,  87,  88,  89,  90,
+     91,  93,  94,  95,  97,  98,  99, 100, 102, 103, 105, 106, 107, 109, 110, 111,
+    113, 114, 116, 117, 119, 120, 121, 123, 124, 126, 127, 129, 130, 132, 133, 135,
+    137, 138, 140, 141, 143, 145, 146, 148, 149, 151, 153, 154, 156, 158, 159, 161,
+    163, 165, 166, 168, 170, 172, 173, 175, 177, 179, 181, 182, 184, 186, 188, 190,
+    192, 194, 196, 197, 199, 201, 203, 205, 207, 209, 211, 213, 215, 217, 219, 221,
+    223, 225, 227, 229, 231, 234, 236, 238, 240, 242, 244, 246, 248, 251, 253, 255
+};
+#define WS2812_LEVEL(v, scale) ws2812_gamma_lut[((v) * (scale)) >> 8]
+#else
+#define WS2812_LEVEL(v, scale) (((v) * (scale)) >> 8)
+#endif
+
+// 全局亮度 0-255，在编码时与 gamma 一起作用，帧缓冲中始终保存原始颜色
+static uint8_t ws2812_brightness = 255;
+
+// 0/1 码比较值，由 HAL_WS2812_SetSlotLevels 设置
+static uint32_t ws2812_slot_low;
+static uint32_t ws2812_slot_delta;
+
+void HAL_WS2812_SetSlotLevels(uint16_t t0h, uint16_t t1h)
+{
+    ws2812_slot_low = t0h;
+    ws2812_slot_delta = (uint32_t)(t1h - t0h);
+}
+
+// 以下编码函数的 bits 参数（24 / 32）在各调用点都是常量，内联后循环次数在编译期确定
+
+// 逐 bit 判断的原始实现
+static inline void HAL_WS2812_EncodeLoop(WS2812_Slot *slot, uint32_t word, const int bits)
+{
+#if (WS2812_DMA_WIDTH == 8)
+    // 字节槽位：4 个 bit 拼成一个字整字写入，小端下低字节先发
+    for (int bit = 0; bit < bits; bit += 4)
+    {
+        uint32_t out = 0;
+        for (int k = 0; k < 4; k++)
+        {
+            uint32_t ccr = (word & (1U << (bits - 1 - bit - k))) ? ws2812_slot_low + ws2812_slot_delta : ws2812_slot_low;
+            out |= ccr << (8 * k);
+        }
+        memcpy(&slot[bit], &out, sizeof(out));
+    }
+#else
+    for (int bit = 0; bit < bits; bit++)
+    {
+        slot[bit] = (word & (1U << (bits - 1 - bit))) ? ws2812_slot_low + ws2812_slot_delta : ws2812_slot_low;
+    }
+#endif
+}
+
+#if (WS2812_ENCODER == WS2812_ENCODER_NIBBLE) || WS2812_ENCODE_BENCH
+static inline void HAL_WS2812_EncodeNibble(WS2812_Slot *slot, uint32_t word, const int bits)
+{
+    const uint32_t low = ws2812_slot_low * WS2812_SLOT_REPEAT;
+    const uint32_t delta = ws2812_slot_delta;
+
+    for (int shift = bits - 4; shift >= 0; shift -= 4)
+    {
+        const uint32_t *w = ws2812_nibble_lut[(word >> shift) & 0xF];
+        for (int k = 0; k < WS2812_NIBBLE_WORDS; k++, slot += WS2812_SLOTS_PER_WORD)
+        {
+            uint32_t out = w[k] * delta + low;
+            memcpy(slot, &out, sizeof(out));
+        }
+    }
+}
+#endif
+
+#if (WS2812_ENCODER == WS2812_ENCODER_BYTE) || WS2812_ENCODE_BENCH
+static inline void HAL_WS2812_EncodeByte(WS2812_Slot *slot, uint32_t word, const int bits)
+{
+    const uint32_t low = ws2812_slot_low * WS2812_SLOT_REPEAT;
+    const uint32_t delta = ws2812_slot_delta;
+
+    for (int shift = bits - 8; shift >= 0; shift -= 8)
+    {
+        const uint32_t *w = ws2812_byte_lut[(word >> shift) & 0xFF];
+        for (int k = 0; k < 2 * WS2812_NIBBLE_WORDS; k++, slot += WS2812_SLOTS_PER_WORD)
+        {
+            uint32_t out = w[k] * delta + low;
+            memcpy(slot, &out, sizeof(out));
+        }
+    }
+}
+#endif
+
+// 编码方式由 WS2812_ENCODER 在编译期选择
+static inline void HAL_WS2812_EncodeWord(WS2812_Slot *slot, uint32_t word, const int bits)
+{
+#if (WS2812_ENCODER == WS2812_ENCODER_NIBBLE)
+    HAL_WS2812_EncodeNibble(slot, word, bits);
+#elif (WS2812_ENCODER == WS2812_ENCODER_BYTE)
+    HAL_WS2812_EncodeByte(slot, word, bits);
+#else
+    HAL_WS2812_EncodeLoop(slot, word, bits);
+#endif
+}
+
+// 把一个 GRB 像素展开成 24 个比较值
+void HAL_WS2812_EncodeSlots(WS2812_Slot *slot, uint32_t grb) { HAL_WS2812_EncodeWord(slot, grb, 24); }
+
+void HAL_WS2812_SetBrightness(uint8_t bri) { ws2812_brightness = bri; }
+
+uint8_t HAL_WS2812_GetBrightness(void) { return ws2812_brightness; }
+
+// 每种颜色顺序生成一个专用的取字函数和连续编码函数：顺序和位数在编译期确定，逐灯循环里没有分支。
+// 亮度缩放（乘法 + 移位，scale = 256 时原值不变）后查 gamma 表，再按顺序拼成 24 / 32 位的字。
+// 32 位 RGBW 灯在 WS2812_AUTO_WHITE 打开时，把 RGB 的公共部分 min(r, g, b) 移到白色通道。
+#define WS2812_PACK(name, bits, pack)                                                                              \
+    static inline uint32_t HAL_WS2812_Pack_##name(const WS2812_Color *c, uint32_t scale)                           \
+    {                                                                                                              \
+        uint32_t g = c->green, r = c->red, b = c->blue, w = c->white;                                              \
+        if ((bits) == 32 && WS2812_AUTO_WHITE)                                                                     \
+        {                                                                                                          \
+            uint32_t m = (r < g) ? r : g;                                                                          \
+            m = (b < m) ? b : m;                                                                                   \
+            g -= m;                                                                                                \
+            r -= m;                                                                                                \
+            b -= m;                                                                                                \
+            w = (w + m > 255U) ? 255U : w + m;                                                                     \
+        }                                                                                                          \
+        g = WS2812_LEVEL(g, scale);                                                                                \
+        r = WS2812_LEVEL(r, scale);                                                                                \
+        b = WS2812_LEVEL(b, scale);                                                                                \
+        w = WS2812_LEVEL(w, scale);                                                                                \
+        return (pack);                                                                                             \
+    }                                                                                                              \
+    static uint32_t HAL_WS2812_PackOne_##name(const WS2812_Color *c)                                               \
+    {                                                                                                              \
+        return HAL_WS2812_Pack_##name(c, ws2812_brightness + 1U);                                                  \
+    }                                                                                                              \
+    static void HAL_WS2812_EncodeRun_##name(WS2812_Slot *slot, const WS2812_Color *c, uint16_t n)                  \
+    {                                                                                                              \
+        const uint32_t scale = ws2812_brightness + 1U;                                                             \
+        for (; n > 0; n--, c++, slot += (bits))                                                                    \
+            HAL_WS2812_EncodeWord(slot, HAL_WS2812_Pack_##name(c, scale), (bits));                                 \
+    }
+
+WS2812_PACK(GRB, 24, g << 16 | r << 8 | b)
+WS2812_PACK(RGB, 24, r << 16 | g << 8 | b)
+WS2812_PACK(BRG, 24, b << 16 | r << 8 | g)
+WS2812_PACK(RBG, 24, r << 16 | b << 8 | g)
+WS2812_PACK(GBR, 24, g << 16 | b << 8 | r)
+WS2812_PACK(BGR, 24, b << 16 | g << 8 | r)
+#if WS2812_RGBW
+WS2812_PACK(GRBW, 32, g << 24 | r << 16 | b << 8 | w)
+WS2812_PACK(RGBW, 32, r << 24 | g << 16 | b << 8 | w)
+#endif
+
+#define WS2812_ORDER_TABLE(fn)                                                                                     \
+    {fn##_GRB, fn##_RGB, fn##_BRG, fn##_RBG, fn##_GBR, fn##_BGR, WS2812_ORDER_TABLE_W(fn)}
+#if WS2812_RGBW
+#define WS2812_ORDER_TABLE_W(fn) fn##_GRBW, fn##_RGBW
+#else
+#define WS2812_ORDER_TABLE_W(fn)
+#endif
+
+// 下标为 WS2812_ORDER_xxx，未编译的顺序为 NULL
+static const WS2812_EncodeRunFn ws2812_encode_run[WS2812_ORDER_NUM] = WS2812_ORDER_TABLE(HAL_WS2812_EncodeRun);
+static const WS2812_PackFn ws2812_pack[WS2812_ORDER_NUM] = WS2812_ORDER_TABLE(HAL_WS2812_PackOne);
+
+static uint8_t HAL_WS2812_OrderBits(uint8_t order) { return (order >= WS2812_ORDER_GRBW) ? 32 : 24; }
+
+// 取指定颜色顺序的编码函数，bits 返回每灯槽位数
+WS2812_EncodeRunFn HAL_WS2812_GetEncoder(uint8_t order, uint8_t *bits)
+{
+    if (order >= WS2812_ORDER_NUM)
+        return NULL;
+    if (bits != NULL)
+        *bits = HAL_WS2812_OrderBits(order);
+    return ws2812_encode_run[order];
+}
+
+// 取指定颜色顺序的取字函数（含亮度和 gamma），供不走比较值槽位的输出方式使用
+WS2812_PackFn HAL_WS2812_GetPacker(uint8_t order, uint8_t *bits)
+{
+    if (order >= WS2812_ORDER_NUM)
+        return NULL;
+    if (bits != NULL)
+        *bits = HAL_WS2812_OrderBits(order);
+    return ws2812_pack[order];
+}
+
+/**
+ * @brief 8x8 bit 转置（移位 + 掩码交换，无逐 bit 循环），GPIO 并行模式把各路字节排成位平面
+ * @param lo  第 0 ~ 3 路的字节，第 l 路在 bit 8l 起
+ * @param hi  第 4 ~ 7 路的字节
+ * @param out out[k] 的第 l 位 = 第 l 路字节的第 7 - k 位，即按高位先发的顺序排出 8 个 bit 周期
+ */
+void HAL_WS2812_Transpose8(uint32_t lo, uint32_t hi, uint8_t *out)
+{
+    uint32_t x = hi, y = lo, t;
+
+    t = (x ^ (x >> 7)) & 0x00AA00AAU;
+    x = x ^ t ^ (t << 7);
+    t = (y ^ (y >> 7)) & 0x00AA00AAU;
+    y = y ^ t ^ (t << 7);
+    t = (x ^ (x >> 14)) & 0x0000CCCCU;
+    x = x ^ t ^ (t << 14);
+    t = (y ^ (y >> 14)) & 0x0000CCCCU;
+    y = y ^ t ^ (t << 14);
+    t = (x & 0xF0F0F0F0U) | ((y >> 4) & 0x0F0F0F0FU);
+    y = ((x << 4) & 0xF0F0F0F0U) | (y & 0x0F0F0F0FU);
+    x = t;
+
+    out[0] = (uint8_t)(x >> 24);
+    out[1] = (uint8_t)(x >> 16);
+    out[2] = (uint8_t)(x >> 8);
+    out[3] = (uint8_t)x;
+    out[4] = (uint8_t)(y >> 24);
+    out[5] = (uint8_t)(y >> 16);
+    out[6] = (uint8_t)(y >> 8);
+    out[7] = (uint8_t)y;
+}
+
+#if WS2812_ENCODE_BENCH
+// 供性能对比使用，按指定方式编码
+void HAL_WS2812_EncodeSlotsWith(uint8_t encoder, WS2812_Slot *slot, uint32_t grb)
+{
+    switch (encoder)
+    {
+    case WS2812_ENCODER_NIBBLE:
+        HAL_WS2812_EncodeNibble(slot, grb, 24);
+        break;
+    case WS2812_ENCODER_BYTE:
+        HAL_WS2812_EncodeByte(slot, grb, 24);
+        break;
+    default:
+        HAL_WS2812_EncodeLoop(slot, grb, 24);
+        break;
+    }
+}
+#endif
@@ -0,0 +1,46 @@
+/* hal_ws2812_spi.c - SPI 后端编码：每个 WS2812 bit 展开成 3 / 4 个 SPI 位 */
+#include "hal_ws2812.h"
+
+#if WS2812_SPI_BACKEND
+// 半字节 -> 4 个 WS2812 bit 的 SPI 位串（12 / 16 位），按当前时序在初始化时生成
+static uint16_t spi_nibble[16];
+static uint8_t spi_sub_bits = 3;
+
+void HAL_WS2812_SpiSetLevels(const WS2812_SpiTiming *t)
+{
+    const uint16_t zero = 1U << (t->sub_bits - 1U);
+    const uint16_t one = ((1U << t->one_bits) - 1U) << (t->sub_bits - t->one_bits);
+
+    spi_sub_bits = t->sub_bits;
+    for (uint8_t v = 0; v < 16; v++)
+    {
+        uint16_t bits = 0;
+        for (int8_t b = 3; b >= 0; b--)
+            bits = (uint16_t)(bits << t->sub_bits) | (((v >> b) & 1U) ? one : zero);
+        spi_nibble[v] = bits;
+    }
+}
+
+// 连续编码 n 个像素，每灯 bits * sub_bits / 8 字节（24 bit 灯 9 / 12 字节），MSB 先发
+void HAL_WS2812_SpiEncode(uint8_t *dst, WS2812_PackFn pack, uint8_t bits, const WS2812_Color *c, uint16_t n)
+{
+    const uint8_t sub4 = spi_sub_bits * 4U;
+
+    for (; n > 0; n--, c++)
+    {
+        uint32_t word = pack(c);
+
+        for (int8_t shift = bits - 8; shift >= 0; shift -= 8)
+        {
+            uint32_t byte = (word >> shift) & 0xFFU;
+            uint32_t v = ((uint32_t)spi_nibble[byte >> 4] << sub4) | spi_nibble[byte & 0x0FU];
+
+            if (spi_sub_bits == 4)
+                *dst++ = (uint8_t)(v >> 24);
+            *dst++ = (uint8_t)(v >> 16);
+            *dst++ = (uint8_t)(v >> 8);
+            *dst++ = (uint8_t)v;
+        }
+    }
+}
+#endif
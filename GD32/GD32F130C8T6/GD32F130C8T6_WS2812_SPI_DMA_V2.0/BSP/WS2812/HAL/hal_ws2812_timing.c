@@ -0,0 +1,138 @@
+/* hal_ws2812_timing.c - 由主频推导波形时序 */
+#include "hal_ws2812_timing.h"
+
+// 协议时序表，下标为 WS2812_PROTO_xxx
+const WS2812_Protocol ws2812_protocols[WS2812_PROTO_NUM] = {
+    // period, period_tol, t0h, t1h, th_tol, reset_us
+    {1250, 600, 400, 800, 150, 50},  // WS2812B：T0H 0.4 us、T1H 0.8 us，±150 ns；复位 ≥ 50 us
+    {2500, 600, 500, 1200, 150, 50}, // WS2811 低速：T0H 0.5 us、T1H 1.2 us，周期 2.5 us
+    {1250, 600, 300, 600, 150, 80},  // SK6812：T0H 0.3 us、T1H 0.6 us；复位 ≥ 80 us
+    {1250, 600, 300, 750, 80, 280},  // WS2813：T0H 220-380 ns、T1H 580-1000 ns；复位 ≥ 280 us
+    {1000, 100, 350, 700, 100, 50},  // 超频：1 us 周期，高电平仍落在 WS2812B 容差内
+};
+
+// 计数换算回纳秒，四舍五入
+uint32_t WS2812_TimingToNs(uint32_t clk_hz, uint32_t ticks)
+{
+    return (uint32_t)(((uint64_t)ticks * 1000000000U + clk_hz / 2U) / clk_hz);
+}
+
+static uint32_t WS2812_NsToTicks(uint32_t clk_hz, uint32_t ns)
+{
+    return (uint32_t)(((uint64_t)ns * clk_hz + 500000000U) / 1000000000U);
+}
+
+static uint8_t WS2812_WithinTol(uint32_t actual, uint32_t target, uint32_t tol)
+{
+    return (actual > target ? actual - target : target - actual) <= tol;
+}
+
+/**
+ * @brief 按主频计算周期与 0/1 码比较值，四舍五入到最近的计数
+ * @param clk_hz 定时器时钟（Hz）
+ * @param p 协议时序
+ * @param t 输出
+ * @return 换算后的时间超出协议允许偏差，或 0/1 码无法区分时返回 WS2812_ERR_INVALID_PARAM
+ */
+WS2812_Status WS2812_TimingCalc(uint32_t clk_hz, const WS2812_Protocol *p, WS2812_Timing *t)
+{
+    uint32_t period, t0h, t1h;
+
+    if (clk_hz == 0 || p == NULL || t == NULL)
+        return WS2812_ERR_INVALID_PARAM;
+
+    period = WS2812_NsToTicks(clk_hz, p->period_ns);
+    t0h = WS2812_NsToTicks(clk_hz, p->t0h_ns);
+    t1h = WS2812_NsToTicks(clk_hz, p->t1h_ns);
+
+    // 0 码至少一个计数的高电平，1 码必须比 0 码长且不能占满整个周期
+    if (t0h == 0 || t1h <= t0h || t1h >= period || t1h > 0xFFFF)
+        return WS2812_ERR_INVALID_PARAM;
+    if (!WS2812_WithinTol(WS2812_TimingToNs(clk_hz, period), p->period_ns, p->period_tol_ns) ||
+        !WS2812_WithinTol(WS2812_TimingToNs(clk_hz, t0h), p->t0h_ns, p->th_tol_ns) ||
+        !WS2812_WithinTol(WS2812_TimingToNs(clk_hz, t1h), p->t1h_ns, p->th_tol_ns))
+        return WS2812_ERR_INVALID_PARAM;
+
+    t->arr = period - 1U;
+    t->t0h = (uint16_t)t0h;
+    t->t1h = (uint16_t)t1h;
+    // 复位按实际周期向上取整
+    t->reset_slots = (uint16_t)(((uint64_t)p->reset_us * clk_hz + 1000000U * (uint64_t)period - 1U) /
+                                (1000000U * (uint64_t)period));
+    return WS2812_OK;
+}
+
+/**
+ * @brief 按 SPI 时钟源选择分频和每 bit 的 SPI 位数
+ * @param pclk_hz SPI 所在 APB 的时钟（Hz）
+ * @param p 协议时序
+ * @param t 输出；优先 3 位编码（缓冲区更小），同样位数下取最快的分频
+ * @return 所有组合都超出协议允许偏差时返回 WS2812_ERR_INVALID_PARAM
+ */
+WS2812_Status WS2812_SpiTimingCalc(uint32_t pclk_hz, const WS2812_Protocol *p, WS2812_SpiTiming *t)
+{
+    if (pclk_hz == 0 || p == NULL || t == NULL)
+        return WS2812_ERR_INVALID_PARAM;
+
+    for (uint8_t sub = 3; sub <= 4; sub++)
+    {
+        for (uint8_t shift = 1; shift <= 8; shift++)
+        {
+            uint32_t tb = 1UL << shift; // 一个 SPI 位的时钟数
+
+            if (!WS2812_WithinTol(WS2812_TimingToNs(pclk_hz, sub * tb), p->period_ns, p->period_tol_ns) ||
+                !WS2812_WithinTol(WS2812_TimingToNs(pclk_hz, tb), p->t0h_ns, p->th_tol_ns))
+                continue;
+            for (uint8_t ones = 2; ones < sub; ones++)
+            {
+                if (!WS2812_WithinTol(WS2812_TimingToNs(pclk_hz, ones * tb), p->t1h_ns, p->th_tol_ns))
+                    continue;
+                t->psc_shift = shift;
+                t->sub_bits = sub;
+                t->one_bits = ones;
+                t->reset_slots = (uint16_t)(((uint64_t)p->reset_us * pclk_hz + 1000000U * (uint64_t)(sub * tb) - 1U) /
+                                            (1000000U * (uint64_t)(sub * tb)));
+                return WS2812_OK;
+            }
+        }
+    }
+    return WS2812_ERR_INVALID_PARAM;
+}
+
+/**
+ * @brief 按 USART 时钟选择波特率，取 bit 周期最接近标称值的组合
+ * @param pclk_hz USART 所在 APB 的时钟（Hz）
+ * @param p 协议时序
+ * @param t 输出
+ * @return 所有波特率都超出协议允许偏差时返回 WS2812_ERR_INVALID_PARAM
+ */
+WS2812_Status WS2812_UsartTimingCalc(uint32_t pclk_hz, const WS2812_Protocol *p, WS2812_UsartTiming *t)
+{
+    uint32_t best_err = UINT32_MAX;
+
+    if (pclk_hz == 0 || p == NULL || t == NULL)
+        return WS2812_ERR_INVALID_PARAM;
+
+    // 16 倍过采样下 BAUD 至少为 16；1024 个时钟一位时已远慢于任何协议
+    for (uint32_t c = 16; c <= 1024; c++)
+    {
+        uint32_t period = WS2812_TimingToNs(pclk_hz, WS2812_USART_SLOTS * c);
+        uint32_t err = (period > p->period_ns) ? period - p->period_ns : p->period_ns - period;
+
+        if (err > p->period_tol_ns || err >= best_err ||
+            !WS2812_WithinTol(WS2812_TimingToNs(pclk_hz, c), p->t0h_ns, p->th_tol_ns))
+            continue;
+        for (uint8_t ones = 2; ones < WS2812_USART_SLOTS; ones++)
+        {
+            if (!WS2812_WithinTol(WS2812_TimingToNs(pclk_hz, ones * c), p->t1h_ns, p->th_tol_ns))
+                continue;
+            best_err = err;
+            t->clocks = (uint16_t)c;
+            t->one_slots = ones;
+            t->reset_slots = (uint16_t)(((uint64_t)p->reset_us * pclk_hz + 1000000U * (uint64_t)(WS2812_USART_SLOTS * c) - 1U) /
+                                        (1000000U * (uint64_t)(WS2812_USART_SLOTS * c)));
+            break;
+        }
+    }
+    return (best_err == UINT32_MAX) ? WS2812_ERR_INVALID_PARAM : WS2812_OK;
+}
@@ -0,0 +1,54 @@
+/* hal_ws2812_timing.h - 由主频推导波形时序 */
+#ifndef HAL_WS2812_TIMING_H
+#define HAL_WS2812_TIMING_H
+
+#include "ws2812_common.h"
+#include <stdint.h>
+
+// 协议时序（数据手册标称值与允许偏差）
+typedef struct
+{
+    uint16_t period_ns;     // bit 周期
+    uint16_t period_tol_ns; // bit 周期允许偏差
+    uint16_t t0h_ns;        // 0 码高电平时间
+    uint16_t t1h_ns;        // 1 码高电平时间
+    uint16_t th_tol_ns;     // 高电平时间允许偏差
+    uint16_t reset_us;      // 最短复位（锁存）时间
+} WS2812_Protocol;
+
+// 换算到定时器计数的结果，预分频固定为 0，定时器时钟即 SystemCoreClock
+typedef struct
+{
+    uint32_t arr; // 周期寄存器 = bit 周期计数 - 1
+    uint16_t t0h; // 0 码比较值
+    uint16_t t1h; // 1 码比较值
+    uint16_t reset_slots; // 最短复位时间对应的槽位数（向上取整）
+} WS2812_Timing;
+
+// SPI 后端：每个 WS2812 bit 用 sub_bits 个 SPI 位表示，0 码为 100(0)，1 码开头 one_bits 个 1
+typedef struct
+{
+    uint8_t psc_shift;    // SPI 分频系数 = 2^psc_shift（1 ~ 8）
+    uint8_t sub_bits;     // 3 或 4
+    uint8_t one_bits;     // 1 码高电平的 SPI 位数
+    uint16_t reset_slots; // 最短复位时间对应的 WS2812 bit 数（向上取整）
+} WS2812_SpiTiming;
+
+// USART 后端：TX 反相后起始位为高、停止位为低，8N1 一帧 10 个位时正好放两个 WS2812 bit，
+// 每个 bit 占 WS2812_USART_SLOTS 个位时，0 码高 1 个位时，1 码高 one_slots 个位时
+#define WS2812_USART_SLOTS 5
+typedef struct
+{
+    uint16_t clocks;      // 每个 USART 位时的时钟数，16 倍过采样时即 BAUD 寄存器值（≥ 16）
+    uint8_t one_slots;    // 2 ~ 4
+    uint16_t reset_slots; // 最短复位时间对应的 WS2812 bit 数（向上取整）
+} WS2812_UsartTiming;
+
+extern const WS2812_Protocol ws2812_protocols[WS2812_PROTO_NUM];
+
+WS2812_Status WS2812_TimingCalc(uint32_t clk_hz, const WS2812_Protocol *p, WS2812_Timing *t);
+uint32_t WS2812_TimingToNs(uint32_t clk_hz, uint32_t ticks);
+WS2812_Status WS2812_SpiTimingCalc(uint32_t pclk_hz, const WS2812_Protocol *p, WS2812_SpiTiming *t);
+WS2812_Status WS2812_UsartTimingCalc(uint32_t pclk_hz, const WS2812_Protocol *p, WS2812_UsartTiming *t);
+
+#endif
@@ -0,0 +1,38 @@
+/* hal_ws2812_usart.c - USART 后端编码：反相 8N1，每个 UART 字节发送 2 个 WS2812 bit */
+#include "hal_ws2812.h"
+
+#if WS2812_USART_BACKEND
+// 2 个 WS2812 bit（高位为先发的那个）-> 1 个 UART 字节，按当前时序在初始化时生成
+static uint8_t usart_pair[4];
+
+/**
+ * @brief 生成 bit 对查找表
+ * @note  一帧的位时顺序：起始位、d0 ~ d7（LSB 先发）、停止位；反相后起始位为高、停止位为低，
+ *        数据位 0 为高。第一个 bit 占起始位和 d0 ~ d3，第二个 bit 占 d4 ~ d7 和停止位
+ */
+void HAL_WS2812_UsartSetLevels(const WS2812_UsartTiming *t)
+{
+    for (uint8_t v = 0; v < 4; v++)
+    {
+        uint8_t high_a = (v & 2U) ? t->one_slots : 1U; // 第一个 bit 的高电平位时数，含起始位
+        uint8_t high_b = (v & 1U) ? t->one_slots : 1U; // 第二个 bit 的高电平位时数，从 d4 起
+        uint8_t byte = 0xFF;
+
+        byte &= (uint8_t)~((1U << (high_a - 1U)) - 1U);
+        byte &= (uint8_t)~(((1U << high_b) - 1U) << 4);
+        usart_pair[v] = byte;
+    }
+}
+
+// 连续编码 n 个像素，每灯 bits / 2 字节（24 bit 灯 12 字节）
+void HAL_WS2812_UsartEncode(uint8_t *dst, WS2812_PackFn pack, uint8_t bits, const WS2812_Color *c, uint16_t n)
+{
+    for (; n > 0; n--, c++)
+    {
+        uint32_t word = pack(c);
+
+        for (int8_t shift = bits - 2; shift >= 0; shift -= 2)
+            *dst++ = usart_pair[(word >> shift) & 3U];
+    }
+}
+#endif
@@ -1,6 +1,16 @@
 #include "ll_ws2812.h"
+#include "ws2812_common.h"
 #include "gd32f1x0.h"
 
+// DMA 内存位宽跟随波形缓冲区槽位宽度，外设侧固定 32 位写 CH2CV
+#if (WS2812_DMA_WIDTH == 8)
+#define LL_WS2812_DMA_MEMORY_WIDTH DMA_MEMORY_WIDTH_8BIT
+#elif (WS2812_DMA_WIDTH == 16)
+#define LL_WS2812_DMA_MEMORY_WIDTH DMA_MEMORY_WIDTH_16BIT
+#else
+#define LL_WS2812_DMA_MEMORY_WIDTH DMA_MEMORY_WIDTH_32BIT
+#endif
+
 // 定义全局变量
 volatile uint8_t dma_busy = 0;
 
@@ -12,7 +22,7 @@ void LL_WS2812_GPIO_Init(void)
     gpio_af_set(GPIOB, GPIO_AF_2, GPIO_PIN_10);
 }
 
-void LL_WS2812_TIMER_DMA_Init(void)
+void LL_WS2812_TIMER_DMA_Init(uint32_t arr)
 {
     timer_parameter_struct timerpara;
     timer_oc_parameter_struct ocpara;
@@ -20,11 +30,11 @@ void LL_WS2812_TIMER_DMA_Init(void)
     rcu_periph_clock_enable(RCU_TIMER1);
     timer_deinit(TIMER1);
 
-    /* 基本定时器：72MHz，ARR=89 => 1.25us 周期 */
+    /* 基本定时器：周期由调用者按主频算好，72MHz 时 ARR=89 => 1.25us 周期 */
     timerpara.prescaler = TIMER_PSC1;
     timerpara.alignedmode = TIMER_COUNTER_EDGE;
     timerpara.counterdirection = TIMER_COUNTER_UP;
-    timerpara.period = TIMER_ARR1;
+    timerpara.period = arr;
     timerpara.clockdivision = TIMER_CKDIV_DIV1;
     timerpara.repetitioncounter = 0;
     timer_init(TIMER1, &timerpara);
@@ -42,8 +52,8 @@ void LL_WS2812_TIMER_DMA_Init(void)
     timer_channel_output_mode_config(TIMER1, TIMER_CH_2, TIMER_OC_MODE_PWM0);
     timer_channel_output_shadow_config(TIMER1, TIMER_CH_2, TIMER_OC_SHADOW_DISABLE);
 
-    /* 初始比较值为低电平 */
-    timer_channel_output_pulse_value_config(TIMER1, TIMER_CH_2, WS2812_LOW_CCR);
+    /* 初始比较值为 0：定时器启动后第一个周期 DMA 还没写入，保持低电平，不能输出多余的 0 码 */
+    timer_channel_output_pulse_value_config(TIMER1, TIMER_CH_2, 0);
 
     /* 启用输出状态（重要） */
     timer_channel_output_state_config(TIMER1, TIMER_CH_2, ENABLE);
@@ -59,13 +69,435 @@ void LL_WS2812_TIMER_DMA_Init(void)
     timer_auto_reload_shadow_enable(TIMER1);
 }
 
-void LL_WS2812_StartTransfer(uint32_t *buffer, uint32_t length)
+void LL_WS2812_DMA_Init(void)
+{
+    dma_parameter_struct dma_init_struct;
+
+    rcu_periph_clock_enable(RCU_DMA);
+    dma_deinit(DMA_CH1);
+
+    /* 内存 -> CH2CV，内存地址在每次发送时配置 */
+    dma_init_struct.periph_addr = (uint32_t)(&TIMER_CH2CV(TIMER1));
+    dma_init_struct.memory_addr = 0;
+    dma_init_struct.direction = DMA_MEMORY_TO_PERIPHERAL;
+    dma_init_struct.periph_width = DMA_PERIPHERAL_WIDTH_32BIT;
+    dma_init_struct.memory_width = LL_WS2812_DMA_MEMORY_WIDTH;
+    dma_init_struct.periph_inc = DMA_PERIPH_INCREASE_DISABLE;
+    dma_init_struct.memory_inc = DMA_MEMORY_INCREASE_ENABLE;
+    dma_init_struct.number = 0;
+    dma_init_struct.priority = DMA_PRIORITY_HIGH;
+    dma_init(DMA_CH1, &dma_init_struct);
+
+    dma_circulation_disable(DMA_CH1);
+    dma_memory_to_memory_disable(DMA_CH1);
+
+    // 传输完成中断，DMA_CH1 对应 DMA_Channel1_2_IRQn
+    dma_interrupt_enable(DMA_CH1, DMA_INT_FTF);
+    nvic_irq_enable(DMA_Channel1_2_IRQn, 1, 0);
+#if WS2812_TIMER_LATCH
+    // 锁存计时用 TIMER1 更新中断，优先级与 DMA 中断相同，两者不会互相打断
+    nvic_irq_enable(TIMER1_IRQn, 1, 0);
+#endif
+}
+
+#if (WS2812_MULTI_LANES > 1)
+// TIMER1 各通道的输出引脚，均为 AF2
+static const struct
+{
+    uint32_t port;
+    uint32_t pin;
+    rcu_periph_enum clk;
+} ll_ws2812_lane_pin[4] = {
+    {GPIOA, GPIO_PIN_0, RCU_GPIOA},   // CH0
+    {GPIOA, GPIO_PIN_1, RCU_GPIOA},   // CH1
+    {GPIOB, GPIO_PIN_10, RCU_GPIOB},  // CH2
+    {GPIOB, GPIO_PIN_11, RCU_GPIOB},  // CH3
+};
+
+/**
+ * @brief 多路并行输出：TIMER1 的 first_ch 起连续 lanes 个通道同时输出，
+ *        每个更新事件由 DMA 突发传输一次写入所有通道的比较值
+ * @note  需在 LL_WS2812_TIMER_DMA_Init、LL_WS2812_DMA_Init 之后调用，
+ *        DMA 外设地址改为 TIMER_DMATB，内存中按 [槽位][通道] 交织存放
+ */
+void LL_WS2812_BurstInit(uint8_t first_ch, uint8_t lanes)
+{
+    timer_oc_parameter_struct ocpara;
+
+    ocpara.outputstate = TIMER_CCX_ENABLE;
+    ocpara.outputnstate = TIMER_CCXN_DISABLE;
+    ocpara.ocpolarity = TIMER_OC_POLARITY_HIGH;
+    ocpara.ocnpolarity = TIMER_OCN_POLARITY_HIGH;
+    ocpara.ocidlestate = TIMER_OC_IDLE_STATE_HIGH;
+    ocpara.ocnidlestate = TIMER_OCN_IDLE_STATE_LOW;
+
+    for (uint8_t ch = first_ch; ch < first_ch + lanes; ch++)
+    {
+        rcu_periph_clock_enable(ll_ws2812_lane_pin[ch].clk);
+        gpio_mode_set(ll_ws2812_lane_pin[ch].port, GPIO_MODE_AF, GPIO_PUPD_NONE, ll_ws2812_lane_pin[ch].pin);
+        gpio_output_options_set(ll_ws2812_lane_pin[ch].port, GPIO_OTYPE_PP, GPIO_OSPEED_50MHZ,
+                                ll_ws2812_lane_pin[ch].pin);
+        gpio_af_set(ll_ws2812_lane_pin[ch].port, GPIO_AF_2, ll_ws2812_lane_pin[ch].pin);
+
+        timer_channel_output_config(TIMER1, ch, &ocpara);
+        timer_channel_output_mode_config(TIMER1, ch, TIMER_OC_MODE_PWM0);
+        timer_channel_output_shadow_config(TIMER1, ch, TIMER_OC_SHADOW_DISABLE);
+        timer_channel_output_pulse_value_config(TIMER1, ch, 0);
+    }
+
+    // 从 CHxCV 开始连续写 lanes 个寄存器
+    timer_dma_transfer_config(TIMER1, DMACFG_DMATA(13U + first_ch), DMACFG_DMATC(lanes - 1U));
+    dma_periph_address_config(DMA_CH1, (uint32_t)(&TIMER_DMATB(TIMER1)));
+}
+#endif
+
+#if (WS2812_GPIO_LANES > 1)
+// 三个 DMA 通道都由 TIMER1 触发：更新事件 -> CH1，CH0 比较 -> CH4，CH1 比较 -> CH2
+#define LL_WS2812_DMA_SET DMA_CH1
+#define LL_WS2812_DMA_DATA DMA_CH4
+#define LL_WS2812_DMA_CLEAR DMA_CH2
+
+// 置位和清零通道每次都写同一个引脚掩码
+static uint32_t ll_gpio_mask;
+
+static void LL_WS2812_GPIO_DMAChannel(dma_channel_enum ch, uint32_t periph, uint32_t memory_width,
+                                      uint32_t memory_inc)
+{
+    dma_parameter_struct dma_init_struct;
+
+    dma_deinit(ch);
+    dma_init_struct.periph_addr = periph;
+    dma_init_struct.memory_addr = (uint32_t)&ll_gpio_mask;
+    dma_init_struct.direction = DMA_MEMORY_TO_PERIPHERAL;
+    dma_init_struct.periph_width = DMA_PERIPHERAL_WIDTH_32BIT;
+    dma_init_struct.memory_width = memory_width;
+    dma_init_struct.periph_inc = DMA_PERIPH_INCREASE_DISABLE;
+    dma_init_struct.memory_inc = memory_inc;
+    dma_init_struct.number = 0;
+    dma_init_struct.priority = DMA_PRIORITY_ULTRA_HIGH;
+    dma_init(ch, &dma_init_struct);
+    dma_circulation_disable(ch);
+    dma_memory_to_memory_disable(ch);
+}
+
+/**
+ * @brief GPIO 并行输出：PB0 起 lanes 个引脚，每个 bit 周期三次 DMA 写 GPIOB
+ *        更新事件：BOP 置位全部引脚；CH0 比较（t0h）：BC 按数据拉低 0 码的引脚；CH1 比较（t1h）：BC 拉低全部引脚
+ * @note  数据字节按 8 位读、32 位写 BC，高位补零；72 MHz 下每周期 90 个时钟，主频过低时 DMA 来不及响应
+ */
+void LL_WS2812_ParallelInit(uint8_t lanes, uint32_t arr, uint16_t t0h, uint16_t t1h)
 {
-    // 关 DMA、配置长度、开 DMA、开定时器
+    timer_parameter_struct timerpara;
+    uint32_t pins = (1UL << lanes) - 1U;
+
+    ll_gpio_mask = pins;
+
+    rcu_periph_clock_enable(RCU_GPIOB);
+    gpio_bit_reset(GPIOB, pins);
+    gpio_mode_set(GPIOB, GPIO_MODE_OUTPUT, GPIO_PUPD_NONE, pins);
+    gpio_output_options_set(GPIOB, GPIO_OTYPE_PP, GPIO_OSPEED_50MHZ, pins);
+
+    rcu_periph_clock_enable(RCU_TIMER1);
+    timer_deinit(TIMER1);
+
+    timerpara.prescaler = TIMER_PSC1;
+    timerpara.alignedmode = TIMER_COUNTER_EDGE;
+    timerpara.counterdirection = TIMER_COUNTER_UP;
+    timerpara.period = arr;
+    timerpara.clockdivision = TIMER_CKDIV_DIV1;
+    timerpara.repetitioncounter = 0;
+    timer_init(TIMER1, &timerpara);
+
+    // 两个比较通道只产生事件，不输出到引脚
+    timer_channel_output_mode_config(TIMER1, TIMER_CH_0, TIMER_OC_MODE_TIMING);
+    timer_channel_output_mode_config(TIMER1, TIMER_CH_1, TIMER_OC_MODE_TIMING);
+    timer_channel_output_pulse_value_config(TIMER1, TIMER_CH_0, t0h);
+    timer_channel_output_pulse_value_config(TIMER1, TIMER_CH_1, t1h);
+
+    // 通道 DMA 请求在比较事件时发出，而不是更新事件
+    timer_channel_dma_request_source_select(TIMER1, TIMER_DMAREQUEST_CHANNELEVENT);
+    timer_dma_enable(TIMER1, TIMER_DMA_UPD | TIMER_DMA_CH0D | TIMER_DMA_CH1D);
+
+    rcu_periph_clock_enable(RCU_DMA);
+    LL_WS2812_GPIO_DMAChannel(LL_WS2812_DMA_SET, (uint32_t)&GPIO_BOP(GPIOB), DMA_MEMORY_WIDTH_32BIT,
+                              DMA_MEMORY_INCREASE_DISABLE);
+    LL_WS2812_GPIO_DMAChannel(LL_WS2812_DMA_DATA, (uint32_t)&GPIO_BC(GPIOB), DMA_MEMORY_WIDTH_8BIT,
+                              DMA_MEMORY_INCREASE_ENABLE);
+    LL_WS2812_GPIO_DMAChannel(LL_WS2812_DMA_CLEAR, (uint32_t)&GPIO_BC(GPIOB), DMA_MEMORY_WIDTH_32BIT,
+                              DMA_MEMORY_INCREASE_DISABLE);
+
+    // 清零通道最后结束，用它的传输完成中断表示整帧（含复位）发完，同样在 DMA_Channel1_2_IRQn
+    dma_interrupt_enable(LL_WS2812_DMA_CLEAR, DMA_INT_FTF);
+    nvic_irq_enable(DMA_Channel1_2_IRQn, 1, 0);
+}
+
+/**
+ * @brief 发送一帧位平面数据
+ * @param planes      每个 bit 周期一个字节
+ * @param data_slots  有效 bit 周期数，置位和数据通道只传这么多次
+ * @param total_slots 有效加复位的 bit 周期数；复位期间引脚不再置位，保持低电平
+ */
+void LL_WS2812_ParallelStart(const uint8_t *planes, uint32_t data_slots, uint32_t total_slots)
+{
+    dma_channel_disable(LL_WS2812_DMA_SET);
+    dma_channel_disable(LL_WS2812_DMA_DATA);
+    dma_channel_disable(LL_WS2812_DMA_CLEAR);
+    dma_memory_address_config(LL_WS2812_DMA_DATA, (uint32_t)planes);
+    dma_transfer_number_config(LL_WS2812_DMA_SET, data_slots);
+    dma_transfer_number_config(LL_WS2812_DMA_DATA, data_slots);
+    dma_transfer_number_config(LL_WS2812_DMA_CLEAR, total_slots);
+    dma_busy = 1;
+    dma_channel_enable(LL_WS2812_DMA_SET);
+    dma_channel_enable(LL_WS2812_DMA_DATA);
+    dma_channel_enable(LL_WS2812_DMA_CLEAR);
+
+    // 计数器从 ARR 开始，第一个时钟就溢出产生更新事件，保证每个周期先置位再比较
+    timer_counter_value_config(TIMER1, TIMER_CAR(TIMER1));
+    timer_enable(TIMER1);
+}
+#endif
+
+void LL_WS2812_StartTransfer(const void *buffer, uint32_t length)
+{
+    // 关 DMA、配置地址和长度、开 DMA、开定时器
     dma_channel_disable(DMA_CH1);
+    dma_memory_address_config(DMA_CH1, (uint32_t)buffer);
     dma_transfer_number_config(DMA_CH1, length);
+    dma_busy = 1;
     dma_channel_enable(DMA_CH1);
     timer_enable(TIMER1);
 }
 
+// 循环模式：半传输和全传输中断交替触发，由上层补填空闲的一半
+void LL_WS2812_StartCircular(const void *buffer, uint32_t length)
+{
+    dma_channel_disable(DMA_CH1);
+    dma_circulation_enable(DMA_CH1);
+    dma_memory_address_config(DMA_CH1, (uint32_t)buffer);
+    dma_transfer_number_config(DMA_CH1, length);
+    dma_interrupt_enable(DMA_CH1, DMA_INT_HTF);
+    dma_busy = 1;
+    dma_channel_enable(DMA_CH1);
+    timer_enable(TIMER1);
+}
+
+void LL_WS2812_StopTransfer(void)
+{
+    timer_disable(TIMER1);
+#if (WS2812_GPIO_LANES > 1)
+    dma_channel_disable(LL_WS2812_DMA_SET);
+    dma_channel_disable(LL_WS2812_DMA_DATA);
+    dma_channel_disable(LL_WS2812_DMA_CLEAR);
+#else
+    dma_channel_disable(DMA_CH1);
+#endif
+    dma_busy = 0; // 标记传输完成
+}
+
+#if WS2812_SPI_BACKEND
+/**
+ * @brief SPI 后端：SPI0 主机只发送，MOSI 为 PA7（AF0），DMA_CH2 写 SPI_DATA
+ * @param psc_shift 分频系数 2^psc_shift，SPI0 挂在 APB2 上
+ * @note  发送结束后 SPI 保持使能，MOSI 停在最后一位（复位字节为 0），即低电平
+ */
+void LL_WS2812_SPI_Init(uint8_t psc_shift)
+{
+    spi_parameter_struct spi_init_struct;
+    dma_parameter_struct dma_init_struct;
+
+    rcu_periph_clock_enable(RCU_GPIOA);
+    rcu_periph_clock_enable(RCU_SPI0);
+    rcu_periph_clock_enable(RCU_DMA);
+
+    gpio_af_set(GPIOA, GPIO_AF_0, GPIO_PIN_7);
+    gpio_mode_set(GPIOA, GPIO_MODE_AF, GPIO_PUPD_PULLDOWN, GPIO_PIN_7);
+    gpio_output_options_set(GPIOA, GPIO_OTYPE_PP, GPIO_OSPEED_50MHZ, GPIO_PIN_7);
+
+    spi_i2s_deinit(SPI0);
+    spi_init_struct.device_mode = SPI_MASTER;
+    spi_init_struct.trans_mode = SPI_TRANSMODE_BDTRANSMIT;
+    spi_init_struct.frame_size = SPI_FRAMESIZE_8BIT;
+    spi_init_struct.nss = SPI_NSS_SOFT;
+    spi_init_struct.endian = SPI_ENDIAN_MSB;
+    spi_init_struct.clock_polarity_phase = SPI_CK_PL_LOW_PH_1EDGE;
+    spi_init_struct.prescale = CTL0_PSC(psc_shift - 1U);
+    spi_init(SPI0, &spi_init_struct);
+    spi_enable(SPI0);
+
+    dma_deinit(DMA_CH2);
+    dma_init_struct.periph_addr = (uint32_t)(&SPI_DATA(SPI0));
+    dma_init_struct.memory_addr = 0;
+    dma_init_struct.direction = DMA_MEMORY_TO_PERIPHERAL;
+    dma_init_struct.periph_width = DMA_PERIPHERAL_WIDTH_8BIT;
+    dma_init_struct.memory_width = DMA_MEMORY_WIDTH_8BIT;
+    dma_init_struct.periph_inc = DMA_PERIPH_INCREASE_DISABLE;
+    dma_init_struct.memory_inc = DMA_MEMORY_INCREASE_ENABLE;
+    dma_init_struct.number = 0;
+    dma_init_struct.priority = DMA_PRIORITY_HIGH;
+    dma_init(DMA_CH2, &dma_init_struct);
+    dma_circulation_disable(DMA_CH2);
+    dma_memory_to_memory_disable(DMA_CH2);
+
+    // SPI0_TX 对应 DMA_CH2，与定时器后端共用 DMA_Channel1_2_IRQn
+    dma_interrupt_enable(DMA_CH2, DMA_INT_FTF);
+    nvic_irq_enable(DMA_Channel1_2_IRQn, 1, 0);
+}
+
+void LL_WS2812_SPI_StartTransfer(const void *buffer, uint32_t length)
+{
+    dma_channel_disable(DMA_CH2);
+    dma_memory_address_config(DMA_CH2, (uint32_t)buffer);
+    dma_transfer_number_config(DMA_CH2, length);
+    dma_busy = 1;
+    dma_channel_enable(DMA_CH2);
+    spi_dma_enable(SPI0, SPI_DMA_TRANSMIT);
+}
+
+void LL_WS2812_SPI_StopTransfer(void)
+{
+    spi_dma_disable(SPI0, SPI_DMA_TRANSMIT);
+    dma_channel_disable(DMA_CH2);
+    dma_busy = 0;
+}
+#endif
+
+#if WS2812_USART_BACKEND
+// 复位段不从缓冲区取数据，DMA 重复发送这个字节只为按波特率计时
+static const uint8_t ll_usart_idle = 0xFF;
+
+/**
+ * @brief USART 后端：USART1 TX 为 PA2（AF1），TX 引脚反相，DMA_CH3 写 TDATA；USART0 留给调试串口
+ * @param baudrate 每个位时对应一个 USART 位，USART1 挂在 APB1 上
+ */
+void LL_WS2812_USART_Init(uint32_t baudrate)
+{
+    dma_parameter_struct dma_init_struct;
+
+    rcu_periph_clock_enable(RCU_GPIOA);
+    rcu_periph_clock_enable(RCU_USART1);
+    rcu_periph_clock_enable(RCU_DMA);
+
+    gpio_af_set(GPIOA, GPIO_AF_1, GPIO_PIN_2);
+    gpio_bit_reset(GPIOA, GPIO_PIN_2);
+    gpio_mode_set(GPIOA, GPIO_MODE_OUTPUT, GPIO_PUPD_PULLDOWN, GPIO_PIN_2);
+    gpio_output_options_set(GPIOA, GPIO_OTYPE_PP, GPIO_OSPEED_50MHZ, GPIO_PIN_2);
+
+    // 反相只能在 USART 关闭时配置
+    usart_deinit(USART1);
+    usart_baudrate_set(USART1, baudrate);
+    usart_word_length_set(USART1, USART_WL_8BIT);
+    usart_stop_bit_set(USART1, USART_STB_1BIT);
+    usart_parity_config(USART1, USART_PM_NONE);
+    usart_invert_config(USART1, USART_TXPIN_ENABLE);
+    usart_transmit_config(USART1, USART_TRANSMIT_ENABLE);
+    usart_enable(USART1);
+
+    dma_deinit(DMA_CH3);
+    dma_init_struct.periph_addr = (uint32_t)(&USART_TDATA(USART1));
+    dma_init_struct.memory_addr = 0;
+    dma_init_struct.direction = DMA_MEMORY_TO_PERIPHERAL;
+    dma_init_struct.periph_width = DMA_PERIPHERAL_WIDTH_8BIT;
+    dma_init_struct.memory_width = DMA_MEMORY_WIDTH_8BIT;
+    dma_init_struct.periph_inc = DMA_PERIPH_INCREASE_DISABLE;
+    dma_init_struct.memory_inc = DMA_MEMORY_INCREASE_ENABLE;
+    dma_init_struct.number = 0;
+    dma_init_struct.priority = DMA_PRIORITY_HIGH;
+    dma_init(DMA_CH3, &dma_init_struct);
+    dma_circulation_disable(DMA_CH3);
+    dma_memory_to_memory_disable(DMA_CH3);
+
+    // USART1_TX 对应 DMA_CH3，在 DMA_Channel3_4_IRQn；发送完成（TC）中断在 USART1_IRQn
+    dma_interrupt_enable(DMA_CH3, DMA_INT_FTF);
+    nvic_irq_enable(DMA_Channel3_4_IRQn, 1, 0);
+    nvic_irq_enable(USART1_IRQn, 1, 0);
+}
+
+// 发送数据段：引脚切回 USART，反相后空闲电平为低
+void LL_WS2812_USART_StartTransfer(const void *buffer, uint32_t length)
+{
+    dma_channel_disable(DMA_CH3);
+    gpio_mode_set(GPIOA, GPIO_MODE_AF, GPIO_PUPD_PULLDOWN, GPIO_PIN_2);
+    dma_memory_increase_enable(DMA_CH3);
+    dma_memory_address_config(DMA_CH3, (uint32_t)buffer);
+    dma_transfer_number_config(DMA_CH3, length);
+    dma_busy = 1;
+    dma_channel_enable(DMA_CH3);
+    usart_dma_transmit_config(USART1, USART_TRANSMIT_DMA_ENABLE);
+}
+
+// DMA 完成时最后一两个字节还在发送，打开 TC 中断等移位寄存器发空
+void LL_WS2812_USART_WaitIdle(void) { usart_interrupt_enable(USART1, USART_INT_TC); }
+
+/**
+ * @brief 发送复位段：引脚切为 GPIO 输出低电平，USART 照常按波特率发 length 个字节，
+ *        DMA 完成即复位时间到；每个 UART 字节都带高电平起始位，复位不能直接由 USART 输出
+ */
+void LL_WS2812_USART_StartReset(uint32_t length)
+{
+    usart_interrupt_disable(USART1, USART_INT_TC);
+    gpio_mode_set(GPIOA, GPIO_MODE_OUTPUT, GPIO_PUPD_PULLDOWN, GPIO_PIN_2);
+    dma_channel_disable(DMA_CH3);
+    dma_memory_increase_disable(DMA_CH3);
+    dma_memory_address_config(DMA_CH3, (uint32_t)&ll_usart_idle);
+    dma_transfer_number_config(DMA_CH3, length);
+    dma_channel_enable(DMA_CH3);
+}
+
+void LL_WS2812_USART_StopTransfer(void)
+{
+    usart_interrupt_disable(USART1, USART_INT_TC);
+    usart_dma_transmit_config(USART1, USART_TRANSMIT_DMA_DISABLE);
+    dma_channel_disable(DMA_CH3);
+    dma_busy = 0;
+}
+#endif
+
+#if WS2812_TIMER_LATCH
+/**
+ * @brief 数据（含末尾一个 0 槽位）已由 DMA 写完，开始锁存计时
+ * @param latch_arr 锁存周期的 ARR；ARR 带预装载，当前 0 槽位周期结束后才生效
+ * @note  关掉更新 DMA 请求，防止已完成的通道在重新配置后立即响应积压的请求
+ */
+void LL_WS2812_LatchBegin(uint32_t latch_arr)
+{
+    timer_dma_disable(TIMER1, TIMER_DMA_UPD);
+    dma_channel_disable(DMA_CH1);
+    timer_autoreload_value_config(TIMER1, latch_arr);
+    timer_interrupt_flag_clear(TIMER1, TIMER_INT_FLAG_UP);
+    timer_interrupt_enable(TIMER1, TIMER_INT_UP);
+    dma_busy = 0; // 波形缓冲区已读完，可以编码下一帧
+}
+
+// 锁存周期已开始：ARR 改回 bit 周期，锁存结束的更新事件起生效
+void LL_WS2812_LatchRestore(uint32_t arr) { timer_autoreload_value_config(TIMER1, arr); }
+
+// 锁存期间提交的下一帧：先配好 DMA，更新请求由 LL_WS2812_LatchRelease 打开
+void LL_WS2812_LatchArm(const void *buffer, uint32_t length)
+{
+    dma_memory_address_config(DMA_CH1, (uint32_t)buffer);
+    dma_transfer_number_config(DMA_CH1, length);
+    dma_busy = 1;
+    dma_channel_enable(DMA_CH1);
+}
+
+// 打开更新 DMA 请求，下一个更新事件（锁存结束）写入第一个 bit
+void LL_WS2812_LatchRelease(void) { timer_dma_enable(TIMER1, TIMER_DMA_UPD); }
+
+// 锁存结束：没有下一帧时停止定时器，比较值保持 0，恢复更新 DMA 请求供下次 StartTransfer 使用
+void LL_WS2812_LatchEnd(uint8_t next_armed)
+{
+    timer_interrupt_disable(TIMER1, TIMER_INT_UP);
+    if (next_armed)
+        return;
+    timer_disable(TIMER1);
+    timer_dma_enable(TIMER1, TIMER_DMA_UPD);
+}
+#endif
+
+#if (WS2812_GPIO_LANES > 1)
+uint32_t LL_WS2812_GetRemaining(void) { return dma_transfer_number_get(LL_WS2812_DMA_CLEAR); }
+#else
+uint32_t LL_WS2812_GetRemaining(void) { return dma_transfer_number_get(DMA_CH1); }
+#endif
+
 uint8_t LL_WS2812_IsDMABusy(void) { return dma_busy; }
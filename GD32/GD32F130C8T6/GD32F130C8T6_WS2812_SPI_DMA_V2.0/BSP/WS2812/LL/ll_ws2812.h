@@ -5,17 +5,35 @@
 #include <stdint.h>
 
 // 硬件相关定义
+// 预分频固定为 0，周期和比较值由 hal_ws2812_timing 按主频计算
 #define TIMER_PSC1 0
-#define TIMER_ARR1 89
-#define WS2812_HIGH_CCR 57
-#define WS2812_LOW_CCR 28
 
 // 声明全局变量为 extern
 extern volatile uint8_t dma_busy;
 
 void LL_WS2812_GPIO_Init(void);
-void LL_WS2812_TIMER_DMA_Init(void);
-void LL_WS2812_StartTransfer(uint32_t *buffer, uint32_t length);
+void LL_WS2812_TIMER_DMA_Init(uint32_t arr);
+void LL_WS2812_DMA_Init(void);
+void LL_WS2812_BurstInit(uint8_t first_ch, uint8_t lanes);
+void LL_WS2812_ParallelInit(uint8_t lanes, uint32_t arr, uint16_t t0h, uint16_t t1h);
+void LL_WS2812_ParallelStart(const uint8_t *planes, uint32_t data_slots, uint32_t total_slots);
+void LL_WS2812_StartTransfer(const void *buffer, uint32_t length);
+void LL_WS2812_StartCircular(const void *buffer, uint32_t length);
+void LL_WS2812_StopTransfer(void);
+void LL_WS2812_SPI_Init(uint8_t psc_shift);
+void LL_WS2812_SPI_StartTransfer(const void *buffer, uint32_t length);
+void LL_WS2812_SPI_StopTransfer(void);
+void LL_WS2812_USART_Init(uint32_t baudrate);
+void LL_WS2812_USART_StartTransfer(const void *buffer, uint32_t length);
+void LL_WS2812_USART_WaitIdle(void);
+void LL_WS2812_USART_StartReset(uint32_t length);
+void LL_WS2812_USART_StopTransfer(void);
+void LL_WS2812_LatchBegin(uint32_t latch_arr);
+void LL_WS2812_LatchRestore(uint32_t arr);
+void LL_WS2812_LatchArm(const void *buffer, uint32_t length);
+void LL_WS2812_LatchRelease(void);
+void LL_WS2812_LatchEnd(uint8_t next_armed);
+uint32_t LL_WS2812_GetRemaining(void);
 uint8_t LL_WS2812_IsDMABusy(void);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,38 @@
+/* link_frame.c - 上位机侧的二进制帧组帧 */
+#include "link_frame.h"
+#include "ws2812_link.h"
+#include <string.h>
+
+uint32_t link_crc32(const uint8_t *p, size_t n)
+{
+    uint32_t c = 0xFFFFFFFFU;
+
+    while (n--)
+    {
+        c ^= *p++;
+        for (int k = 0; k < 8; k++)
+            c = (c >> 1) ^ (0xEDB88320U & (0U - (c & 1U)));
+    }
+    return ~c;
+}
+
+size_t link_frame(uint8_t *out, uint8_t type, uint8_t seq, const uint8_t *payload, uint16_t len)
+{
+    size_t n = WS2812_LINK_HEADER + ((len + 3U) & ~3U);
+    uint32_t crc;
+
+    memset(out, 0, n);
+    out[0] = WS2812_LINK_SYNC0;
+    out[1] = WS2812_LINK_SYNC1;
+    out[2] = type;
+    out[3] = seq;
+    out[4] = (uint8_t)len;
+    out[5] = (uint8_t)(len >> 8);
+    out[6] = (uint8_t)~len;
+    out[7] = (uint8_t)(~len >> 8);
+    memcpy(out + WS2812_LINK_HEADER, payload, len);
+    crc = link_crc32(out, n);
+    for (int i = 0; i < 4; i++)
+        out[n + i] = (uint8_t)(crc >> (8 * i));
+    return n + 4;
+}
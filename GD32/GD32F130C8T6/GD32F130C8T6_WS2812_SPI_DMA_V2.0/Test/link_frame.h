@@ -0,0 +1,16 @@
+/* link_frame.h - 上位机侧的二进制帧组帧，格式见 ws2812_link.h
+ * 与固件无关，只依赖帧格式常量，可直接拿到上位机程序里用
+ */
+#ifndef LINK_FRAME_H
+#define LINK_FRAME_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// 按位计算的 CRC-32，与 zlib crc32 相同
+uint32_t link_crc32(const uint8_t *p, size_t n);
+
+// 组一帧写到 out，返回整帧字节数；out 至少要有 WS2812_LINK_HEADER + 补齐后的 len + 4 字节
+size_t link_frame(uint8_t *out, uint8_t type, uint8_t seq, const uint8_t *payload, uint16_t len);
+
+#endif
@@ -0,0 +1,166 @@
+/* stub.c - 主机测试用的外设库与驱动层替身
+ * CRC 单元按 GD32F1x0 用户手册逐位模拟：多项式 0x04C11DB7 高位先移，
+ * 输入可按字节 / 半字 / 字位反转，输出可整字位反转，复位时装入初值寄存器（默认全 1）
+ */
+#include "stub.h"
+#include "ws2812_driver.h"
+#include "ws2812_pacer.h"
+#include "ws2812_config.h"
+#include "usart.h"
+#include <string.h>
+
+WS2812_Color stub_pixels[WS2812_LED_POOL];
+uint16_t stub_led_count = WS2812_LED_NUM;
+uint8_t stub_brightness = 255;
+uint32_t stub_pixel_writes;
+uint16_t stub_saved_count;
+uint8_t stub_busy;
+uint32_t stub_updates;
+WS2812_Color stub_shown[WS2812_LED_POOL];
+uint16_t stub_rx_chunk = 0xFFFF;
+
+static uint8_t rx_buf[4096];
+static uint16_t rx_head, rx_tail;
+
+void stub_reset(void)
+{
+    memset(stub_pixels, 0, sizeof(stub_pixels));
+    memset(stub_shown, 0, sizeof(stub_shown));
+    stub_led_count = WS2812_LED_NUM;
+    stub_brightness = 255;
+    stub_pixel_writes = 0;
+    stub_saved_count = 0;
+    stub_busy = 0;
+    stub_updates = 0;
+    stub_rx_chunk = 0xFFFF;
+    rx_head = rx_tail = 0;
+}
+
+void stub_rx_push(const uint8_t *data, uint16_t len)
+{
+    memcpy(&rx_buf[rx_head], data, len);
+    rx_head += len;
+}
+
+uint16_t uart_rx_peek(const uint8_t **data)
+{
+    uint16_t n = rx_head - rx_tail;
+
+    *data = &rx_buf[rx_tail];
+    return n < stub_rx_chunk ? n : stub_rx_chunk;
+}
+
+void uart_rx_consume(uint16_t len)
+{
+    rx_tail += len;
+    if (rx_tail == rx_head)
+        rx_head = rx_tail = 0;
+}
+
+uint32_t uart_rx_overrun(void) { return 0; }
+
+void WS2812_PacerPause(uint8_t pause) { (void)pause; }
+
+WS2812_Status WS2812_SetPixel(uint16_t idx, WS2812_Color col)
+{
+    if (idx >= stub_led_count)
+        return WS2812_ERR_INVALID_PARAM;
+    stub_pixels[idx] = col;
+    stub_pixel_writes++;
+    return WS2812_OK;
+}
+
+WS2812_Status WS2812_Update(void)
+{
+    if (stub_busy)
+        return WS2812_ERR_DMA_BUSY;
+    memcpy(stub_shown, stub_pixels, sizeof(stub_shown));
+    stub_updates++;
+    return WS2812_OK;
+}
+
+void WS2812_SetBrightness(uint8_t bri) { stub_brightness = bri; }
+
+WS2812_Status WS2812_SetLedCount(uint16_t count)
+{
+    if (count == 0 || count > WS2812_LED_POOL)
+        return WS2812_ERR_INVALID_PARAM;
+    stub_led_count = count;
+    return WS2812_OK;
+}
+
+WS2812_Status WS2812_SaveLedCount(uint16_t count)
+{
+    stub_saved_count = count;
+    return WS2812_OK;
+}
+
+void rcu_periph_clock_enable(rcu_periph_enum periph) { (void)periph; }
+
+static struct
+{
+    uint32_t data;
+    uint32_t idata;
+    uint32_t rev_i;
+    uint8_t rev_o;
+} crc = {0xFFFFFFFFU, 0xFFFFFFFFU, CRC_INPUT_DATA_NOT, 0};
+
+static uint32_t reverse(uint32_t v, int bits)
+{
+    uint32_t r = 0;
+
+    for (int i = 0; i < bits; i++)
+        r |= ((v >> i) & 1U) << (bits - 1 - i);
+    return r;
+}
+
+// 写入 bits 位数据（8 / 16 / 32），按输入反转方式处理后高位先移进移位寄存器
+static void crc_write(uint32_t v, int bits)
+{
+    if (crc.rev_i == CRC_INPUT_DATA_WORD)
+        v = reverse(v, bits); // 按写入宽度整体反转，字格式即 32 位反转
+    else if (crc.rev_i == CRC_INPUT_DATA_HALFWORD)
+        for (int i = 0; i < bits; i += 16)
+            v = (v & ~(0xFFFFU << i)) | reverse((v >> i) & 0xFFFFU, 16) << i;
+    else if (crc.rev_i == CRC_INPUT_DATA_BYTE)
+        for (int i = 0; i < bits; i += 8)
+            v = (v & ~(0xFFU << i)) | reverse((v >> i) & 0xFFU, 8) << i;
+
+    for (int i = bits - 1; i >= 0; i--)
+    {
+        uint32_t bit = ((crc.data >> 31) ^ (v >> i)) & 1U;
+        crc.data = (crc.data << 1) ^ (bit ? 0x04C11DB7U : 0U);
+    }
+}
+
+static uint32_t crc_read(void) { return crc.rev_o ? reverse(crc.data, 32) : crc.data; }
+
+void crc_deinit(void)
+{
+    crc.idata = 0xFFFFFFFFU;
+    crc.data = 0xFFFFFFFFU;
+    crc.rev_i = CRC_INPUT_DATA_NOT;
+    crc.rev_o = 0;
+}
+
+void crc_reverse_output_data_enable(void) { crc.rev_o = 1; }
+
+void crc_reverse_output_data_disable(void) { crc.rev_o = 0; }
+
+void crc_data_register_reset(void) { crc.data = crc.idata; }
+
+void crc_input_data_reverse_config(uint32_t data_reverse) { crc.rev_i = data_reverse; }
+
+uint32_t crc_block_data_calculate(void *array, uint32_t size, uint8_t data_format)
+{
+    for (uint32_t i = 0; i < size; i++)
+    {
+        if (data_format == INPUT_FORMAT_WORD)
+            crc_write(((const uint32_t *)array)[i], 32);
+        else if (data_format == INPUT_FORMAT_HALFWORD)
+            crc_write(((const uint16_t *)array)[i], 16);
+        else
+            crc_write(((const uint8_t *)array)[i], 8);
+    }
+    return crc_read();
+}
@@ -0,0 +1,26 @@
+/* stub.h - 主机测试用的外设库与驱动层替身 */
+#ifndef STUB_H
+#define STUB_H
+
+#include "ws2812_common.h"
+#include <stdint.h>
+
+// 驱动层接口的调用结果，测试直接检查
+extern WS2812_Color stub_pixels[WS2812_LED_POOL];
+extern uint16_t stub_led_count;
+extern uint8_t stub_brightness;
+extern uint32_t stub_pixel_writes; // WS2812_SetPixel 成功写入的次数
+extern uint16_t stub_saved_count;  // 最近一次 WS2812_SaveLedCount 的参数，没调用过为 0
+
+// WS2812_Update：stub_busy 非 0 时返回 WS2812_ERR_DMA_BUSY，成功时把帧缓冲拷进 stub_shown
+extern uint8_t stub_busy;
+extern uint32_t stub_updates;
+extern WS2812_Color stub_shown[WS2812_LED_POOL];
+
+// 串口接收：uart_rx_peek 每次最多给出 stub_rx_chunk 字节，模拟数据分几次到达
+void stub_rx_push(const uint8_t *data, uint16_t len);
+extern uint16_t stub_rx_chunk;
+
+void stub_reset(void);
+
+#endif
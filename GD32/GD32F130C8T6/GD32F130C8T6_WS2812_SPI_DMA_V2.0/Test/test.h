@@ -0,0 +1,50 @@
+/* test.h - 主机测试用的最小断言 */
+#ifndef TEST_H
+#define TEST_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static int test_fail;
+
+// 失败时打印位置和表达式，继续执行，由 TEST_END 汇总
+#define CHECK(cond)                                                                                                \
+    do                                                                                                             \
+    {                                                                                                              \
+        if (!(cond))                                                                                               \
+        {                                                                                                          \
+            printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond);                                        \
+            test_fail++;                                                                                           \
+        }                                                                                                          \
+    } while (0)
+
+#define CHECK_EQ(a, b)                                                                                             \
+    do                                                                                                             \
+    {                                                                                                              \
+        unsigned long _a = (unsigned long)(a), _b = (unsigned long)(b);                                            \
+        if (_a != _b)                                                                                              \
+        {                                                                                                          \
+            printf("%s:%d: %s = 0x%lX, expected 0x%lX\n", __FILE__, __LINE__, #a, _a, _b);                         \
+            test_fail++;                                                                                           \
+        }                                                                                                          \
+    } while (0)
+
+#define TEST_END()                                                                                                 \
+    do                                                                                                             \
+    {                                                                                                              \
+        printf("%s: %s\n", __FILE__, test_fail ? "FAIL" : "ok");                                                   \
+        return test_fail ? EXIT_FAILURE : EXIT_SUCCESS;                                                            \
+    } while (0)
+
+// 可复现的伪随机数（xorshift32）
+static uint32_t test_rand_state = 2463534242U;
+static inline uint32_t test_rand(void)
+{
+    test_rand_state ^= test_rand_state << 13;
+    test_rand_state ^= test_rand_state >> 17;
+    test_rand_state ^= test_rand_state << 5;
+    return test_rand_state;
+}
+
+#endif
@@ -0,0 +1,75 @@
+/* test_encode.c - 查表编码与逐 bit 编码结果一致，附主机上的每灯耗时对比 */
+#include "hal_ws2812.h"
+#include "test.h"
+#include <string.h>
+#include <time.h>
+
+static const char *const name[] = {"loop", "nibble", "byte"};
+
+static double now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+// 与 WS2812_EncodeBenchmark 相同的循环，主机上只用来看相对快慢，不作断言
+static void bench(void)
+{
+    static WS2812_Slot scratch[WS2812_BITS_PER_LED] __attribute__((aligned(4)));
+    const uint32_t rounds = 1000000;
+
+    for (uint8_t enc = WS2812_ENCODER_LOOP; enc <= WS2812_ENCODER_BYTE; enc++)
+    {
+        double start = now_ns();
+        for (uint32_t i = 0; i < rounds; i++)
+        {
+            HAL_WS2812_EncodeSlotsWith(enc, scratch, i * 0x010305U);
+            __asm__ volatile("" : : "r"(scratch) : "memory");
+        }
+        printf("[encode] %d-bit %-6s %.1f ns/LED\n", WS2812_DMA_WIDTH, name[enc], (now_ns() - start) / rounds);
+    }
+}
+
+int main(void)
+{
+    static WS2812_Slot ref[24] __attribute__((aligned(4)));
+    static WS2812_Slot out[24] __attribute__((aligned(4)));
+
+    const uint16_t levels[][2] = {{29, 58}, {19, 38}, {0, 1}, {100, 250}};
+
+    CHECK(sizeof(WS2812_Slot) == WS2812_DMA_WIDTH / 8);
+    for (unsigned l = 0; l < sizeof(levels) / sizeof(levels[0]); l++)
+    {
+        HAL_WS2812_SetSlotLevels(levels[l][0], levels[l][1]);
+
+        // 全部单 bit 为 1 的字和随机字，两种查表法都要与逐 bit 编码逐槽位相同
+        for (uint32_t n = 0; n < 24 + 4096; n++)
+        {
+            uint32_t grb = (n < 24) ? (1U << n) : (test_rand() & 0xFFFFFFU);
+
+            HAL_WS2812_EncodeSlotsWith(WS2812_ENCODER_LOOP, ref, grb);
+            for (uint8_t enc = WS2812_ENCODER_NIBBLE; enc <= WS2812_ENCODER_BYTE; enc++)
+            {
+                memset(out, 0xA5, sizeof(out));
+                HAL_WS2812_EncodeSlotsWith(enc, out, grb);
+                if (memcmp(out, ref, sizeof(ref)) != 0)
+                {
+                    printf("%s differs: grb %06lX, levels %u/%u\n", name[enc], (unsigned long)grb, levels[l][0],
+                           levels[l][1]);
+                    test_fail++;
+                }
+            }
+        }
+        // 逐 bit 编码本身：高位先发，槽位只取两个比较值
+        HAL_WS2812_EncodeSlotsWith(WS2812_ENCODER_LOOP, ref, 0x800001U);
+        CHECK_EQ(ref[0], levels[l][1]);
+        CHECK_EQ(ref[1], levels[l][0]);
+        CHECK_EQ(ref[22], levels[l][0]);
+        CHECK_EQ(ref[23], levels[l][1]);
+    }
+
+    bench();
+    TEST_END();
+}
@@ -0,0 +1,152 @@
+/* test_host.c - Adalight / TPM2 解析：录制的字节流、坏帧、发送忙时的新帧 */
+#include "ws2812_host.h"
+#include "stub.h"
+#include "test.h"
+#include <string.h>
+
+static WS2812_HostStats st;
+
+// 3 个灯：红、绿、蓝（上位机按 R G B 发送）
+static const uint8_t rgb3[] = {0xFF, 0, 0, 0, 0xFF, 0, 0, 0, 0xFF};
+
+static size_t adalight(uint8_t *out, const uint8_t *rgb, uint16_t leds)
+{
+    out[0] = 'A', out[1] = 'd', out[2] = 'a';
+    out[3] = (uint8_t)((leds - 1U) >> 8);
+    out[4] = (uint8_t)(leds - 1U);
+    out[5] = out[3] ^ out[4] ^ 0x55U;
+    memcpy(out + 6, rgb, leds * 3U);
+    return 6U + leds * 3U;
+}
+
+static size_t tpm2(uint8_t *out, uint8_t type, const uint8_t *data, uint16_t len, uint8_t end)
+{
+    out[0] = WS2812_TPM2_START, out[1] = type;
+    out[2] = (uint8_t)(len >> 8), out[3] = (uint8_t)len;
+    memcpy(out + 4, data, len);
+    out[4 + len] = end;
+    return 5U + len;
+}
+
+// 逐字节喂给解析器，和一次喂完结果应相同
+static void feed(const uint8_t *p, size_t n, int bytewise)
+{
+    if (!bytewise)
+    {
+        WS2812_HostFeed(p, (uint16_t)n);
+        return;
+    }
+    for (size_t i = 0; i < n; i++)
+        WS2812_HostFeed(&p[i], 1);
+}
+
+static int is_rgb3(const WS2812_Color *c)
+{
+    return c[0].red == 0xFF && c[0].green == 0 && c[1].green == 0xFF && c[1].blue == 0 && c[2].blue == 0xFF &&
+           c[2].red == 0;
+}
+
+int main(void)
+{
+    static uint8_t buf[16 + 3 * (WS2812_LED_POOL + 8)];
+    size_t n;
+
+    for (int bytewise = 0; bytewise < 2; bytewise++)
+    {
+        stub_reset();
+        WS2812_HostInit();
+
+        // 正常的 Adalight 帧
+        n = adalight(buf, rgb3, 3);
+        feed(buf, n, bytewise);
+        CHECK(WS2812_HostFrameReady());
+        CHECK(is_rgb3(stub_pixels));
+        CHECK_EQ(stub_pixel_writes, 3);
+
+        // 帧头校验错误：整帧丢弃，后面的数据当作噪声
+        stub_reset();
+        n = adalight(buf, rgb3, 3);
+        buf[5] ^= 1;
+        feed(buf, n, bytewise);
+        CHECK(!WS2812_HostFrameReady());
+        CHECK_EQ(stub_pixel_writes, 0);
+        WS2812_HostGetStats(&st);
+        CHECK_EQ(st.bad, 1);
+
+        // 帧头字母不对：不算坏帧，也不写帧缓冲
+        n = adalight(buf, rgb3, 3);
+        buf[2] = 'b';
+        feed(buf, n, bytewise);
+        CHECK(!WS2812_HostFrameReady());
+        CHECK_EQ(stub_pixel_writes, 0);
+
+        // TPM2 像素帧
+        n = tpm2(buf, WS2812_TPM2_DATA, rgb3, sizeof(rgb3), WS2812_TPM2_END);
+        feed(buf, n, bytewise);
+        CHECK(WS2812_HostFrameReady());
+        CHECK(is_rgb3(stub_pixels));
+
+        // TPM2 帧尾错误：数据已收完也不能写到帧缓冲
+        stub_reset();
+        n = tpm2(buf, WS2812_TPM2_DATA, rgb3, sizeof(rgb3), 0x00);
+        feed(buf, n, bytewise);
+        CHECK(!WS2812_HostFrameReady());
+        CHECK_EQ(stub_pixel_writes, 0);
+        WS2812_HostGetStats(&st);
+        CHECK_EQ(st.bad, 2);
+
+        // TPM2 非像素帧只跳过
+        n = tpm2(buf, 0xAA, rgb3, sizeof(rgb3), WS2812_TPM2_END);
+        feed(buf, n, bytewise);
+        CHECK(!WS2812_HostFrameReady());
+        CHECK_EQ(stub_pixel_writes, 0);
+
+        // 比灯带长的帧：多出的灯丢弃，不越界
+        static uint8_t many[3 * (WS2812_LED_POOL + 8)];
+        memset(many, 0x5A, sizeof(many));
+        n = adalight(buf, many, WS2812_LED_POOL + 8);
+        feed(buf, n, bytewise);
+        CHECK(WS2812_HostFrameReady());
+        CHECK_EQ(stub_pixel_writes, stub_led_count);
+        WS2812_HostGetStats(&st);
+        CHECK_EQ(st.frames, 3);
+    }
+
+    // 上一帧因发送忙还没发出去时，下一帧的前半段不能混进待发的帧
+    stub_reset();
+    WS2812_HostInit();
+    stub_busy = 1;
+    n = adalight(buf, rgb3, 3);
+    stub_rx_push(buf, (uint16_t)n);
+    WS2812_HostStep(0);
+    CHECK_EQ(stub_updates, 0);
+
+    static const uint8_t white3[9] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+    n = adalight(buf, white3, 3);
+    stub_rx_push(buf, 10); // 帧头加第一个灯多一个字节
+    WS2812_HostStep(1);
+    stub_busy = 0;
+    WS2812_HostStep(2);
+    CHECK_EQ(stub_updates, 1);
+    CHECK(is_rgb3(stub_shown));
+
+    stub_rx_push(buf + 10, (uint16_t)(n - 10));
+    WS2812_HostStep(3);
+    CHECK_EQ(stub_updates, 2);
+    for (int i = 0; i < 3; i++)
+        CHECK(stub_shown[i].red == 0xFF && stub_shown[i].green == 0xFF && stub_shown[i].blue == 0xFF);
+
+    // 发送忙期间连续到了两帧，只发最新的完整帧
+    stub_busy = 1;
+    n = adalight(buf, white3, 3);
+    stub_rx_push(buf, (uint16_t)n);
+    n = adalight(buf, rgb3, 3);
+    stub_rx_push(buf, (uint16_t)n);
+    WS2812_HostStep(4);
+    stub_busy = 0;
+    WS2812_HostStep(5);
+    CHECK_EQ(stub_updates, 3);
+    CHECK(is_rgb3(stub_shown));
+
+    TEST_END();
+}
@@ -0,0 +1,163 @@
+/* test_link.c - 二进制帧协议：CRC 向量、link_frame 组帧、误码、序号与乱码输入 */
+#include "ws2812_link.h"
+#include "link_frame.h"
+#include "stub.h"
+#include "test.h"
+#include <string.h>
+
+// 与 ws2812_host.c 相同的用法：找到同步字后 WS2812_LinkBegin，其余字节逐个 WS2812_LinkPush
+// 返回最后一帧的处理结果，没有收完任何帧时返回 WS2812_LINK_MORE
+static WS2812_LinkResult feed(const uint8_t *p, size_t n)
+{
+    WS2812_LinkResult last = WS2812_LINK_MORE;
+    uint8_t in_frame = 0, prev = 0;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        if (in_frame)
+        {
+            WS2812_LinkResult r = WS2812_LinkPush(p[i]);
+            if (r != WS2812_LINK_MORE)
+            {
+                last = r;
+                in_frame = 0;
+            }
+        }
+        else if (prev == WS2812_LINK_SYNC0 && p[i] == WS2812_LINK_SYNC1)
+        {
+            WS2812_LinkBegin();
+            in_frame = 1;
+        }
+        prev = in_frame ? 0 : p[i];
+    }
+    return last;
+}
+
+int main(void)
+{
+    static uint8_t frame[WS2812_LINK_HEADER + WS2812_LINK_MAX_PAYLOAD + 8];
+    static uint8_t payload[WS2812_LINK_MAX_PAYLOAD];
+    WS2812_LinkStats st;
+    size_t n;
+
+    // 已知向量：CRC-32("123456789") = 0xCBF43926
+    CHECK_EQ(link_crc32((const uint8_t *)"123456789", 9), 0xCBF43926U);
+    // CRC 单元按字节输入、字节内反转时与 zlib 相同，用来确认外设模型本身
+    crc_deinit();
+    crc_input_data_reverse_config(CRC_INPUT_DATA_BYTE);
+    crc_reverse_output_data_enable();
+    crc_data_register_reset();
+    CHECK_EQ(crc_block_data_calculate("123456789", 9, INPUT_FORMAT_BYTE) ^ 0xFFFFFFFFU, 0xCBF43926U);
+
+    // WS2812_LinkInit 的配置（按字输入、整字反转）对字对齐的数据同样等于 zlib crc32
+    stub_reset();
+    WS2812_LinkInit();
+    uint32_t words[2];
+    memcpy(words, "12345678", 8);
+    crc_data_register_reset();
+    CHECK_EQ(crc_block_data_calculate(words, 2, INPUT_FORMAT_WORD) ^ 0xFFFFFFFFU, 0x9AE0DAAFU);
+
+    // 像素帧：起始灯号 5，三个灯的 R G B
+    const uint8_t px[] = {5, 0, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99};
+    n = link_frame(frame, WS2812_LINK_PIXELS, 0, px, sizeof(px));
+    CHECK_EQ(n % 4, 0);
+    CHECK_EQ(feed(frame, n), WS2812_LINK_FRAME);
+    CHECK_EQ(stub_pixels[5].red, 0x11);
+    CHECK_EQ(stub_pixels[5].green, 0x22);
+    CHECK_EQ(stub_pixels[5].blue, 0x33);
+    CHECK_EQ(stub_pixels[7].blue, 0x99);
+    CHECK_EQ(stub_pixel_writes, 3);
+
+    // 命令帧
+    const uint8_t bri[] = {0x40}, cnt[] = {44, 0};
+    n = link_frame(frame, WS2812_LINK_BRIGHTNESS, 1, bri, sizeof(bri));
+    CHECK_EQ(feed(frame, n), WS2812_LINK_FRAME);
+    CHECK_EQ(stub_brightness, 0x40);
+    n = link_frame(frame, WS2812_LINK_LED_COUNT, 2, cnt, sizeof(cnt));
+    CHECK_EQ(feed(frame, n), WS2812_LINK_DONE);
+    CHECK_EQ(stub_led_count, 44);
+    CHECK_EQ(stub_saved_count, 44);
+
+    // 未知类型与过长的长度字段
+    n = link_frame(frame, 0x7F, 3, bri, sizeof(bri));
+    CHECK_EQ(feed(frame, n), WS2812_LINK_DROP);
+    n = link_frame(frame, WS2812_LINK_PIXELS, 4, px, sizeof(px));
+    frame[4] = 0xFF, frame[5] = 0xFF, frame[6] = 0, frame[7] = 0;
+    CHECK_EQ(feed(frame, n), WS2812_LINK_DROP);
+    WS2812_LinkGetStats(&st);
+    CHECK_EQ(st.frames, 4);
+    CHECK_EQ(st.hdr_err, 2);
+    CHECK_EQ(st.crc_err, 0);
+
+    // 任意一个 bit 出错的像素帧都整帧丢弃，不写帧缓冲
+    stub_reset();
+    n = link_frame(frame, WS2812_LINK_PIXELS, 5, px, sizeof(px));
+    for (size_t bit = 16; bit < n * 8; bit++)
+    {
+        frame[bit / 8] ^= (uint8_t)(1U << (bit % 8));
+        CHECK_EQ(feed(frame, n), WS2812_LINK_DROP);
+        frame[bit / 8] ^= (uint8_t)(1U << (bit % 8));
+    }
+    CHECK_EQ(stub_pixel_writes, 0);
+
+    // 序号缺口：上一个 CRC 通过的帧是 3 号（类型未知也计序号），之后发 6、7、10，缺 4、5、8、9
+    WS2812_LinkGetStats(&st);
+    const uint32_t gap = st.seq_gap;
+    const uint8_t seqs[] = {6, 7, 10};
+    for (unsigned i = 0; i < sizeof(seqs); i++)
+    {
+        n = link_frame(frame, WS2812_LINK_BRIGHTNESS, seqs[i], bri, sizeof(bri));
+        CHECK_EQ(feed(frame, n), WS2812_LINK_FRAME);
+    }
+    WS2812_LinkGetStats(&st);
+    CHECK_EQ(st.seq_gap - gap, 4);
+
+    // 重发的 10 号和倒退的 9 号不算缺口，之后按最近的序号接着数：11 紧接 10 之后，没有缺口
+    const uint8_t old[] = {10, 9, 10, 11};
+    for (unsigned i = 0; i < sizeof(old); i++)
+    {
+        n = link_frame(frame, WS2812_LINK_BRIGHTNESS, old[i], bri, sizeof(bri));
+        CHECK_EQ(feed(frame, n), WS2812_LINK_FRAME);
+    }
+    WS2812_LinkGetStats(&st);
+    CHECK_EQ(st.seq_gap - gap, 4);
+    CHECK_EQ(st.seq_old, 2);
+
+    // 长度超出灯带容量：不改灯数，也不写 Flash
+    const uint8_t too_many[] = {(uint8_t)(WS2812_LED_POOL + 1), (uint8_t)((WS2812_LED_POOL + 1) >> 8)};
+    const uint16_t count = stub_led_count;
+    stub_saved_count = 0;
+    n = link_frame(frame, WS2812_LINK_LED_COUNT, 12, too_many, sizeof(too_many));
+    CHECK_EQ(feed(frame, n), WS2812_LINK_DONE);
+    CHECK_EQ(stub_led_count, count);
+    CHECK_EQ(stub_saved_count, 0);
+
+    // 随机长度的像素帧，最长到 WS2812_LINK_MAX_PAYLOAD，全部通过
+    stub_led_count = WS2812_LED_POOL;
+    for (int i = 0; i < 2000; i++)
+    {
+        uint16_t len = (uint16_t)(2 + test_rand() % (WS2812_LINK_MAX_PAYLOAD - 1));
+        for (uint16_t k = 0; k < len; k++)
+            payload[k] = (uint8_t)test_rand();
+        payload[0] = 0, payload[1] = 0;
+        n = link_frame(frame, WS2812_LINK_PIXELS, (uint8_t)(13 + i), payload, len);
+        if (feed(frame, n) != WS2812_LINK_FRAME)
+        {
+            printf("frame of %u bytes rejected\n", len);
+            test_fail++;
+        }
+    }
+
+    // 乱码输入：随机字节里混入同步字，解析器不越界、不接受任何帧
+    WS2812_LinkGetStats(&st);
+    const uint32_t frames = st.frames;
+    static uint8_t noise[1 << 20];
+    for (size_t i = 0; i < sizeof(noise); i++)
+        noise[i] = (test_rand() & 0x1F) == 0 ? WS2812_LINK_SYNC0 + (i & 1U) * (WS2812_LINK_SYNC1 - WS2812_LINK_SYNC0)
+                                             : (uint8_t)test_rand();
+    feed(noise, sizeof(noise));
+    WS2812_LinkGetStats(&st);
+    CHECK_EQ(st.frames, frames);
+
+    TEST_END();
+}
@@ -0,0 +1,129 @@
+/* test_slot8.c - 8 位槽位编码后解码回 GRB，与输入对比 */
+#include "hal_ws2812.h"
+#include "hal_ws2812_timing.h"
+#include "test.h"
+
+static WS2812_Timing tm; // 72 MHz 下的 WS2812B 时序，与目标板初始化时相同
+
+// 各颜色顺序下通道的发送次序，下标为 WS2812_ORDER_xxx
+static const char *const order_seq[WS2812_ORDER_NUM] = {"grb", "rgb", "brg", "rbg", "gbr", "bgr", "grbw", "rgbw"};
+
+// 按比较值把 bits 个槽位还原成高位先发的数据字，遇到不是 0 / 1 码的槽位返回 -1
+static int64_t decode(const uint8_t *slot, int bits)
+{
+    uint32_t word = 0;
+
+    for (int i = 0; i < bits; i++)
+    {
+        if (slot[i] == tm.t1h)
+            word = word << 1 | 1U;
+        else if (slot[i] == tm.t0h)
+            word = word << 1;
+        else
+            return -1;
+    }
+    return word;
+}
+
+// 参考实现：亮度 255、通道只取 0 / 255 时 gamma 不改变数值，按顺序拼字；RGBW 灯提取白色
+static uint32_t pack_ref(uint8_t order, const WS2812_Color *c)
+{
+    uint32_t g = c->green, r = c->red, b = c->blue, w = c->white, word = 0;
+
+    if (order >= WS2812_ORDER_GRBW && WS2812_AUTO_WHITE)
+    {
+        uint32_t m = r < g ? r : g;
+        m = b < m ? b : m;
+        g -= m, r -= m, b -= m;
+        w = w + m > 255U ? 255U : w + m;
+    }
+    for (const char *s = order_seq[order]; *s; s++)
+        word = word << 8 | (*s == 'g' ? g : *s == 'r' ? r : *s == 'b' ? b : w);
+    return word;
+}
+
+int main(void)
+{
+    static WS2812_Slot buf[64 * 32] __attribute__((aligned(4)));
+    WS2812_Color px[64];
+    uint8_t bits;
+
+    CHECK(sizeof(WS2812_Slot) == 1);
+    CHECK(WS2812_TimingCalc(72000000U, &ws2812_protocols[WS2812_PROTO_WS2812B], &tm) == WS2812_OK);
+    CHECK(tm.t1h <= 0xFF); // 8 位槽位的前提
+    HAL_WS2812_SetSlotLevels(tm.t0h, tm.t1h);
+    HAL_WS2812_SetBrightness(255);
+
+    // 已知向量：全 0、单通道满值，检查 G R B 的字节位置和高位先发
+    const uint32_t known[] = {0x000000, 0xFF0000, 0x00FF00, 0x0000FF, 0x800001, 0xFFFFFF};
+    for (unsigned i = 0; i < sizeof(known) / sizeof(known[0]); i++)
+    {
+        HAL_WS2812_EncodeSlots(buf, known[i]);
+        CHECK_EQ(decode(buf, 24), known[i]);
+    }
+    HAL_WS2812_EncodeSlots(buf, 0x800000);
+    CHECK_EQ(buf[0], tm.t1h);
+    CHECK_EQ(buf[1], tm.t0h);
+
+    // 随机像素填满 64 个灯，逐灯解码与输入相同，相邻灯互不覆盖
+    for (int round = 0; round < 1000; round++)
+    {
+        uint32_t grb[64];
+
+        for (int i = 0; i < 64; i++)
+        {
+            grb[i] = test_rand() & 0xFFFFFFU;
+            HAL_WS2812_EncodeSlots(&buf[i * 24], grb[i]);
+        }
+        for (int i = 0; i < 64; i++)
+            CHECK_EQ(decode(&buf[i * 24], 24), grb[i]);
+    }
+
+    // 各种颜色顺序：通道字节落在正确位置，RGBW 灯的公共部分移到白色通道
+    for (uint8_t order = 0; order < WS2812_ORDER_NUM; order++)
+    {
+        WS2812_EncodeRunFn enc = HAL_WS2812_GetEncoder(order, &bits);
+
+        CHECK(enc != NULL);
+        if (enc == NULL)
+            continue;
+        CHECK_EQ(bits, order >= WS2812_ORDER_GRBW ? 32 : 24);
+        for (int round = 0; round < 64; round++)
+        {
+            for (int i = 0; i < 64; i++)
+            {
+                uint32_t v = test_rand();
+                px[i] = (WS2812_Color){(v & 1) ? 255 : 0, (v & 2) ? 255 : 0, (v & 4) ? 255 : 0, (v & 8) ? 255 : 0};
+            }
+            enc(buf, px, 64);
+            for (int i = 0; i < 64; i++)
+                CHECK_EQ(decode(&buf[i * bits], bits), pack_ref(order, &px[i]));
+        }
+    }
+    CHECK(HAL_WS2812_GetEncoder(WS2812_ORDER_NUM, &bits) == NULL);
+
+    // 任意像素和亮度：逐灯解码应等于取字函数（含亮度与 gamma）的结果，GPIO 并行路径共用同一取字函数
+    for (uint8_t order = 0; order < WS2812_ORDER_NUM; order++)
+    {
+        WS2812_EncodeRunFn enc = HAL_WS2812_GetEncoder(order, &bits);
+        WS2812_PackFn pack = HAL_WS2812_GetPacker(order, NULL);
+
+        CHECK(pack != NULL);
+        if (enc == NULL || pack == NULL)
+            continue;
+        for (int round = 0; round < 16; round++)
+        {
+            HAL_WS2812_SetBrightness((uint8_t)test_rand());
+            for (int i = 0; i < 64; i++)
+            {
+                uint32_t v = test_rand();
+                px[i] = (WS2812_Color){(uint8_t)v, (uint8_t)(v >> 8), (uint8_t)(v >> 16), (uint8_t)(v >> 24)};
+            }
+            enc(buf, px, 64);
+            for (int i = 0; i < 64; i++)
+                CHECK_EQ(decode(&buf[i * bits], bits), pack(&px[i]));
+        }
+    }
+
+    TEST_END();
+}
@@ -0,0 +1,158 @@
+/* test_stream.c - 流式发送的 DMA / 中断交错模型
+ *
+ * DMA 每个 bit 周期从乒乓缓冲区读一个槽位，读完一个半区触发 HTF / FTF，
+ * 中断把刚读完的半区补填成后面的灯。模型按时钟周期推进，检查：
+ *   1. HAL_WS2812_StreamClockOk 接受的主频下，中断总在 DMA 绕回该半区之前填完
+ *      （定时器更新时 DMA 预取下一槽位，截止时间再提前一个周期）；被拒绝的主频下确实会迟到；
+ *   2. HAL_WS2812_StreamRefill 里按剩余计数判断迟到的条件，在迟到不足一个半区时与模型里的实际先后一致
+ *      （剩余计数按循环取模，迟到一个半区以上时会混叠，那时输出早已错乱）；
+ *   3. 尾部零槽位累计够复位时间后停止，帧长与灯数相符。
+ */
+#include "hal_ws2812.h"
+#include "hal_ws2812_timing.h"
+#include "test.h"
+
+#define HALF_SLOTS (WS2812_STREAM_LEDS_PER_HALF * 24U)
+
+// 中断耗时按 Cortex-M3 指令数估算的上限（周期），目标板上可用 WS2812_EncodeBenchmark 的实测值替换
+#define IRQ_ENTRY 12U    // 进中断的压栈与取向量
+#define REFILL_FIXED 150U // 判断、取剩余计数、补零槽位、退出
+#define BLOCKING 500U     // 更高优先级中断最多占用的时间，按 SysTick 加串口中断各约 250 个周期计
+static const struct
+{
+    const char *name;
+    uint32_t per_led; // 取字 + gamma + 展开一个灯
+} encoders[] = {{"loop", 400}, {"nibble", 200}, {"byte", 150}};
+
+typedef struct
+{
+    uint32_t leds;     // 本帧灯数
+    uint32_t period;   // bit 周期（时钟数）
+    uint32_t reset;    // 复位槽位数
+    uint32_t per_led;  // 每灯编码耗时
+    uint32_t blocking; // 更高优先级中断最多占用的时间
+    uint32_t misses;   // 补填晚于 DMA 读到该半区的次数
+    uint32_t mismatch; // 迟到不足一个半区时，按剩余计数的判断与实际不符的次数
+    uint32_t slots;    // DMA 实际读出的槽位数
+    uint32_t min_slack; // 最小余量（周期）
+} Model;
+
+static void run(Model *m)
+{
+    uint32_t next = 2U * WS2812_STREAM_LEDS_PER_HALF; // 启动前已填好两个半区
+    uint32_t zeros[2], zero_done = 0, busy_until = 0;
+    uint64_t t;
+
+    if (next > m->leds)
+        next = m->leds;
+    // 启动时的两个半区
+    for (int h = 0; h < 2; h++)
+    {
+        uint32_t n = m->leds > (uint32_t)h * WS2812_STREAM_LEDS_PER_HALF ? m->leds - h * WS2812_STREAM_LEDS_PER_HALF : 0;
+        n = n > WS2812_STREAM_LEDS_PER_HALF ? WS2812_STREAM_LEDS_PER_HALF : n;
+        zeros[h] = HALF_SLOTS - n * 24U;
+    }
+    m->misses = m->mismatch = 0;
+    m->min_slack = UINT32_MAX;
+
+    for (uint32_t k = 0;; k++)
+    {
+        const uint8_t half = k & 1U;
+        const uint64_t event = (uint64_t)(k + 1U) * HALF_SLOTS * m->period; // 读完 half 的时刻
+
+        // 与 HAL_WS2812_StreamRefill 相同：先累计刚读完半区的零槽位，够复位时间就停
+        zero_done += zeros[half];
+        if (zero_done >= m->reset)
+        {
+            m->slots = (k + 1U) * HALF_SLOTS;
+            return;
+        }
+
+        uint32_t n = m->leds - next;
+        n = n > WS2812_STREAM_LEDS_PER_HALF ? WS2812_STREAM_LEDS_PER_HALF : n;
+        next += n;
+        zeros[half] = HALF_SLOTS - n * 24U;
+
+        // 中断在前一个中断结束（尾链）和被更高优先级中断阻塞之后才开始
+        t = event + IRQ_ENTRY + m->blocking;
+        if (t < busy_until)
+            t = busy_until;
+        t += REFILL_FIXED + n * m->per_led;
+        busy_until = (uint32_t)t;
+
+        // DMA 在 event + (HALF_SLOTS - 1) 个周期时预取该半区的第一个槽位
+        const uint64_t deadline = event + (uint64_t)(HALF_SLOTS - 1U) * m->period;
+        const uint8_t late = t > deadline;
+        if (late)
+            m->misses++;
+        else if (deadline - t < m->min_slack)
+            m->min_slack = (uint32_t)(deadline - t);
+
+        // 补填结束时的 DMA 剩余计数（循环模式从 2 * HALF_SLOTS 递减），按 HAL 里的条件判断
+        const uint32_t pos = (uint32_t)((t / m->period + 1U) % (2U * HALF_SLOTS));
+        const uint32_t remaining = 2U * HALF_SLOTS - pos;
+        const uint8_t flagged = (half == 0) ? (remaining > HALF_SLOTS) : (remaining <= HALF_SLOTS);
+        if (t <= deadline + (uint64_t)HALF_SLOTS * m->period && flagged != late)
+            m->mismatch++;
+    }
+}
+
+int main(void)
+{
+    static const uint32_t clocks[] = {8000000U, 24000000U, 48000000U, 72000000U};
+    static const uint32_t counts[] = {1, 2, 3, 5, 60, 300, 1000};
+
+    for (unsigned c = 0; c < sizeof(clocks) / sizeof(clocks[0]); c++)
+    {
+        uint32_t clock_misses = 0;
+
+        for (unsigned p = 0; p < WS2812_PROTO_NUM; p++)
+        {
+            WS2812_Timing tm;
+
+            if (WS2812_TimingCalc(clocks[c], &ws2812_protocols[p], &tm) != WS2812_OK)
+                continue;
+            for (unsigned e = 0; e < sizeof(encoders) / sizeof(encoders[0]); e++)
+            {
+                uint32_t worst = UINT32_MAX, misses = 0;
+
+                for (unsigned i = 0; i < sizeof(counts) / sizeof(counts[0]); i++)
+                {
+                    Model m = {counts[i], tm.arr + 1U, tm.reset_slots, encoders[e].per_led, BLOCKING, 0, 0, 0, 0};
+
+                    run(&m);
+                    CHECK_EQ(m.mismatch, 0);
+                    // 数据槽位一个不少，尾部零槽位不短于复位时间，最多多出一个半区
+                    CHECK(m.slots >= counts[i] * 24U + tm.reset_slots);
+                    CHECK(m.slots < counts[i] * 24U + tm.reset_slots + 2U * HALF_SLOTS);
+                    misses += m.misses;
+                    if (m.min_slack < worst)
+                        worst = m.min_slack;
+                }
+                clock_misses += misses;
+                if (p == WS2812_PROTO_WS2812B && misses)
+                    printf("%2lu MHz %-6s late %lu times\n", (unsigned long)(clocks[c] / 1000000U), encoders[e].name,
+                           (unsigned long)misses);
+                else if (p == WS2812_PROTO_WS2812B)
+                    printf("%2lu MHz %-6s min slack %lu cycles\n", (unsigned long)(clocks[c] / 1000000U),
+                           encoders[e].name, (unsigned long)worst);
+            }
+        }
+        // HAL_WS2812_Init 用同一个判断拒绝流式模式：接受的主频下任何协议、任何编码方式都不能迟到，
+        // 拒绝的主频下确实有组合会迟到
+        if (HAL_WS2812_StreamClockOk(clocks[c]))
+            CHECK_EQ(clock_misses, 0);
+        else
+            CHECK(clock_misses > 0);
+    }
+    CHECK(!HAL_WS2812_StreamClockOk(WS2812_STREAM_MIN_CLOCK - 1U));
+    CHECK(HAL_WS2812_StreamClockOk(72000000U));
+
+    // 反例：72 MHz 下编码一个半区要 5000 多个周期，超过半区时长 4320，必须迟到且能被判断出来
+    Model m = {60, 90, 40, 2500, 0, 0, 0, 0, 0};
+    run(&m);
+    CHECK(m.misses > 0);
+    CHECK_EQ(m.mismatch, 0);
+
+    TEST_END();
+}
@@ -0,0 +1,101 @@
+/* test_timing.c - 各主频下推导出的时序落在协议窗口内 */
+#include "hal_ws2812_timing.h"
+#include "test.h"
+
+// system_gd32f1x0.c 里可选的系统时钟；APB 不分频，定时器、SPI、USART 都用同一个时钟
+static const uint32_t clocks[] = {8000000U, 48000000U, 72000000U};
+
+static const char *const proto_name[WS2812_PROTO_NUM] = {"WS2812B", "WS2811", "SK6812", "WS2813", "FAST"};
+
+// 按浮点换算回纳秒，与被测代码的整数舍入无关
+static double ns(uint32_t clk, uint32_t ticks) { return ticks * 1e9 / clk; }
+
+static int within(double actual, uint32_t target, uint32_t tol) { return actual >= target - (double)tol && actual <= target + (double)tol; }
+
+static void check_window(uint32_t clk, const WS2812_Protocol *p, double period, double t0h, double t1h, double reset)
+{
+    const int before = test_fail;
+
+    CHECK(within(period, p->period_ns, p->period_tol_ns));
+    CHECK(within(t0h, p->t0h_ns, p->th_tol_ns));
+    CHECK(within(t1h, p->t1h_ns, p->th_tol_ns));
+    CHECK(t0h < t1h && t1h < period);
+    CHECK(reset >= p->reset_us * 1000.0); // 复位向上取整，不能短于最短锁存时间
+    if (test_fail != before)
+        printf("  at %lu Hz\n", (unsigned long)clk);
+}
+
+int main(void)
+{
+    WS2812_Timing t;
+
+    // 已知向量：72 MHz 即原来写死的 ARR 89、比较值 29 / 58；48 MHz 为 59、19 / 38
+    CHECK(WS2812_TimingCalc(72000000U, &ws2812_protocols[WS2812_PROTO_WS2812B], &t) == WS2812_OK);
+    CHECK_EQ(t.arr, 89);
+    CHECK_EQ(t.t0h, 29);
+    CHECK_EQ(t.t1h, 58);
+    CHECK_EQ(t.reset_slots, 40);
+    CHECK(WS2812_TimingCalc(48000000U, &ws2812_protocols[WS2812_PROTO_WS2812B], &t) == WS2812_OK);
+    CHECK_EQ(t.arr, 59);
+    CHECK_EQ(t.t0h, 19);
+    CHECK_EQ(t.t1h, 38);
+    CHECK_EQ(t.reset_slots, 40);
+
+    // 参数错误
+    CHECK(WS2812_TimingCalc(0, &ws2812_protocols[0], &t) == WS2812_ERR_INVALID_PARAM);
+    CHECK(WS2812_TimingCalc(72000000U, NULL, &t) == WS2812_ERR_INVALID_PARAM);
+    // 1 MHz 时 0 / 1 码只差不到一个计数，必须拒绝
+    CHECK(WS2812_TimingCalc(1000000U, &ws2812_protocols[WS2812_PROTO_WS2812B], &t) == WS2812_ERR_INVALID_PARAM);
+
+    for (unsigned c = 0; c < sizeof(clocks) / sizeof(clocks[0]); c++)
+    {
+        const uint32_t clk = clocks[c];
+
+        for (unsigned i = 0; i < WS2812_PROTO_NUM; i++)
+        {
+            const WS2812_Protocol *p = &ws2812_protocols[i];
+            WS2812_SpiTiming s;
+            WS2812_UsartTiming u;
+
+            // 定时器后端：每种协议在每个可选主频下都要能用
+            if (WS2812_TimingCalc(clk, p, &t) != WS2812_OK)
+            {
+                printf("timer %s unsupported at %lu Hz\n", proto_name[i], (unsigned long)clk);
+                test_fail++;
+            }
+            else
+            {
+                check_window(clk, p, ns(clk, t.arr + 1U), ns(clk, t.t0h), ns(clk, t.t1h),
+                             ns(clk, (t.arr + 1U) * t.reset_slots));
+                printf("%2lu MHz %-7s timer arr %2lu t0h %2u t1h %2u reset %u\n", (unsigned long)(clk / 1000000U),
+                       proto_name[i], (unsigned long)t.arr, t.t0h, t.t1h, t.reset_slots);
+            }
+
+            // SPI / USART 后端允许在低主频下不可用，可用时结果必须在窗口内
+            if (WS2812_SpiTimingCalc(clk, p, &s) == WS2812_OK)
+            {
+                uint32_t tb = 1UL << s.psc_shift;
+
+                CHECK(s.sub_bits == 3 || s.sub_bits == 4);
+                CHECK(s.one_bits >= 2 && s.one_bits < s.sub_bits);
+                check_window(clk, p, ns(clk, s.sub_bits * tb), ns(clk, tb), ns(clk, s.one_bits * tb),
+                             ns(clk, s.sub_bits * tb * s.reset_slots));
+            }
+            if (WS2812_UsartTimingCalc(clk, p, &u) == WS2812_OK)
+            {
+                CHECK(u.clocks >= 16);
+                CHECK(u.one_slots >= 2 && u.one_slots < WS2812_USART_SLOTS);
+                check_window(clk, p, ns(clk, WS2812_USART_SLOTS * u.clocks), ns(clk, u.clocks),
+                             ns(clk, u.one_slots * u.clocks), ns(clk, WS2812_USART_SLOTS * u.clocks * u.reset_slots));
+            }
+        }
+    }
+
+    // 72 MHz 下 SPI 与 USART 后端都要能驱动 WS2812B
+    WS2812_SpiTiming s;
+    WS2812_UsartTiming u;
+    CHECK(WS2812_SpiTimingCalc(72000000U, &ws2812_protocols[WS2812_PROTO_WS2812B], &s) == WS2812_OK);
+    CHECK(WS2812_UsartTimingCalc(72000000U, &ws2812_protocols[WS2812_PROTO_WS2812B], &u) == WS2812_OK);
+
+    TEST_END();
+}
@@ -0,0 +1,143 @@
+/* test_transpose.c - 8x8 bit 转置，以及 GPIO 并行输出的引脚波形模拟 */
+#include "hal_ws2812.h"
+#include "test.h"
+#include <string.h>
+
+#define LANES 8
+#define LEDS 16
+
+// 逐 bit 的参考实现
+static void transpose_ref(const uint8_t *lane, uint8_t *out)
+{
+    for (int k = 0; k < 8; k++)
+    {
+        out[k] = 0;
+        for (int l = 0; l < 8; l++)
+            out[k] |= (uint8_t)(((lane[l] >> (7 - k)) & 1U) << l);
+    }
+}
+
+static void transpose(const uint8_t *lane, uint8_t *out)
+{
+    uint32_t lo = lane[0] | lane[1] << 8 | lane[2] << 16 | (uint32_t)lane[3] << 24;
+    uint32_t hi = lane[4] | lane[5] << 8 | lane[6] << 16 | (uint32_t)lane[7] << 24;
+
+    HAL_WS2812_Transpose8(lo, hi, out);
+}
+
+/**
+ * @brief 按 LL_WS2812_ParallelInit 的三次 DMA 写 GPIOB 模拟引脚电平，量出每路每个 bit 的高电平计数
+ * @param planes  与 HAL_WS2812_EncodePlanes 相同的 BC 字节，每个 bit 周期一个
+ * @param high    输出，high[bit][lane]
+ */
+static void port_trace(const uint8_t *planes, int bits, uint8_t lanes, const WS2812_Timing *tm, uint16_t high[][LANES])
+{
+    const uint32_t mask = (1UL << lanes) - 1U;
+    uint32_t odr = 0;
+
+    for (int b = 0; b < bits; b++)
+    {
+        for (uint32_t tick = 0; tick <= tm->arr; tick++)
+        {
+            if (tick == 0)
+                odr |= mask; // 更新事件：BOP 置位全部引脚
+            if (tick == tm->t0h)
+                odr &= ~(uint32_t)planes[b]; // CH0 比较：BC 拉低 0 码的引脚，数据字节高位补零
+            if (tick == tm->t1h)
+                odr &= ~mask; // CH1 比较：BC 拉低全部引脚
+            for (uint8_t l = 0; l < LANES; l++)
+                high[b][l] += (odr >> l) & 1U;
+            CHECK((odr & ~mask) == 0); // 没用到的引脚始终为低
+        }
+    }
+}
+
+int main(void)
+{
+    uint8_t lane[8], out[8], ref[8], back[8];
+
+    // 已知向量：对角线、单路全 1
+    const uint8_t diag[8] = {0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01};
+    transpose(diag, out);
+    for (int k = 0; k < 8; k++)
+        CHECK_EQ(out[k], 1U << k);
+    const uint8_t one[8] = {0, 0, 0xFF, 0, 0, 0, 0, 0};
+    transpose(one, out);
+    for (int k = 0; k < 8; k++)
+        CHECK_EQ(out[k], 0x04);
+
+    // 随机字节：与参考实现相同，并能从位平面逐 bit 还原各路字节
+    for (int n = 0; n < 100000; n++)
+    {
+        for (int l = 0; l < 8; l++)
+            lane[l] = (uint8_t)test_rand();
+        transpose(lane, out);
+        transpose_ref(lane, ref);
+        for (int k = 0; k < 8; k++)
+            CHECK_EQ(out[k], ref[k]);
+        for (int l = 0; l < 8; l++)
+        {
+            back[l] = 0;
+            for (int k = 0; k < 8; k++)
+                back[l] |= (uint8_t)(((out[k] >> l) & 1U) << (7 - k));
+            CHECK_EQ(back[l], lane[l]);
+        }
+    }
+
+    // 引脚波形：各路像素按 HAL_WS2812_EncodePlanes 的方式排成位平面，模拟输出后按高电平长度判 0 / 1
+    WS2812_Timing tm;
+    CHECK(WS2812_TimingCalc(72000000U, &ws2812_protocols[WS2812_PROTO_WS2812B], &tm) == WS2812_OK);
+    for (uint8_t lanes = 2; lanes <= LANES; lanes++)
+    {
+        static uint8_t planes[LEDS * 24];
+        static uint16_t high[LEDS * 24][LANES];
+        uint32_t word[LEDS][LANES] = {{0}};
+        const uint8_t mask = (uint8_t)((1U << lanes) - 1U);
+
+        for (int pos = 0; pos < LEDS; pos++)
+        {
+            for (uint8_t l = 0; l < lanes; l++)
+                word[pos][l] = test_rand() & 0xFFFFFFU;
+            for (int shift = 16, k = 0; shift >= 0; shift -= 8, k++)
+            {
+                uint8_t bytes[8] = {0};
+
+                for (uint8_t l = 0; l < lanes; l++)
+                    bytes[l] = (uint8_t)(word[pos][l] >> shift);
+                uint8_t *dst = &planes[pos * 24 + k * 8];
+                transpose(bytes, dst);
+                for (int b = 0; b < 8; b++)
+                    dst[b] = (uint8_t)(~dst[b] & mask);
+            }
+        }
+
+        memset(high, 0, sizeof(high));
+        port_trace(planes, LEDS * 24, lanes, &tm, high);
+        for (int pos = 0; pos < LEDS; pos++)
+        {
+            for (uint8_t l = 0; l < LANES; l++)
+            {
+                uint32_t got = 0;
+
+                for (int b = 0; b < 24; b++)
+                {
+                    uint16_t h = high[pos * 24 + b][l];
+
+                    if (l >= lanes)
+                        CHECK_EQ(h, 0);
+                    else if (h == tm.t1h)
+                        got = got << 1 | 1U;
+                    else
+                    {
+                        CHECK_EQ(h, tm.t0h);
+                        got <<= 1;
+                    }
+                }
+                if (l < lanes)
+                    CHECK_EQ(got, word[pos][l]);
+            }
+        }
+    }
+
+    TEST_END();
+}
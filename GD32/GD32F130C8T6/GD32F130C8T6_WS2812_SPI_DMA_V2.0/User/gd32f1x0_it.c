@@ -35,6 +35,15 @@ OF SUCH DAMAGE.
 #include "gd32f1x0_it.h"
 #include "main.h"
 #include "systick.h"
+#include "hal_ws2812.h"
+#include "usart.h"
+
+#if WS2812_USART_BACKEND && USART_TX_DMA
+#error "WS2812 USART  printf  TX DMA ʹ DMA_CH3ֻܿһ"
+#endif
+#if (WS2812_GPIO_LANES > 1) && USART_RX_DMA
+#error "GPIO 봮ڽ DMA ʹ DMA_CH4ֻܿһ"
+#endif
 
 /*!
     \brief      this function handles NMI exception
@@ -159,10 +168,101 @@ void SysTick_Handler(void) { delay_decrement(); }
 //MARKDMA_CH1жϷҲҪӦDMA_Channel1_2_IRQHandlerȥstartup_gd32f1x0.sвѯ
 void DMA_Channel1_2_IRQHandler(void)
 {
+#if WS2812_STREAM_MODE
+    // ʽͣǰ겹ǰȫ겹
+    if (dma_interrupt_flag_get(DMA_CH1, DMA_INT_FLAG_HTF))
+    {
+        dma_interrupt_flag_clear(DMA_CH1, DMA_INT_FLAG_HTF);
+        HAL_WS2812_StreamRefill(0);
+    }
+    if (dma_interrupt_flag_get(DMA_CH1, DMA_INT_FLAG_FTF))
+    {
+        dma_interrupt_flag_clear(DMA_CH1, DMA_INT_FLAG_FTF);
+        HAL_WS2812_StreamRefill(1);
+    }
+#else
+#if (WS2812_GPIO_LANES > 1) || WS2812_SPI_BACKEND
+    // GPIO еͨSPI ˵ SPI0_TX  DMA_CH2ֻʹжϵͨ
+    if (dma_interrupt_flag_get(DMA_CH2, DMA_INT_FLAG_FTF))
+    {
+        dma_interrupt_flag_clear(DMA_CH2, DMA_INT_FLAG_FTF);
+        HAL_WS2812_TransferComplete();
+    }
+#endif
     if (dma_interrupt_flag_get(DMA_CH1, DMA_INT_FLAG_FTF))
     {
         dma_interrupt_flag_clear(DMA_CH1, DMA_INT_FLAG_FTF);
-        dma_busy = 0; // Ǵ
-        timer_disable(TIMER1);
+        // ֹͣͣ˫ģʽŶӵֱ֡лȥ
+        HAL_WS2812_TransferComplete();
+    }
+#endif
+}
+
+#if WS2812_TIMER_LATCH
+// ʱݷ TIMER1 ʱӳڣжƽ״̬
+void TIMER1_IRQHandler(void)
+{
+    if (timer_interrupt_flag_get(TIMER1, TIMER_INT_FLAG_UP))
+    {
+        timer_interrupt_flag_clear(TIMER1, TIMER_INT_FLAG_UP);
+        HAL_WS2812_LatchTick();
+    }
+}
+#endif
+
+#if WS2812_USART_BACKEND || USART_TX_DMA || USART_RX_DMA
+// DMA_CH3WS2812 USART ˣUSART1_TXݶκ͸λɽ HAL
+//  printf  USART0_TXӳ䣩һη꣬ŷʣµ
+// DMA_CH4USART0_RXӳ䣩ѭչ / ƣ½λ
+void DMA_Channel3_4_IRQHandler(void)
+{
+#if WS2812_USART_BACKEND || USART_TX_DMA
+    if (dma_interrupt_flag_get(DMA_CH3, DMA_INT_FLAG_FTF))
+    {
+        dma_interrupt_flag_clear(DMA_CH3, DMA_INT_FLAG_FTF);
+#if WS2812_USART_BACKEND
+        HAL_WS2812_TransferComplete();
+#else
+        uart_tx_dma_isr();
+#endif
+    }
+#endif
+#if USART_RX_DMA
+    if (dma_interrupt_flag_get(DMA_CH4, DMA_INT_FLAG_HTF))
+    {
+        dma_interrupt_flag_clear(DMA_CH4, DMA_INT_FLAG_HTF);
+        uart_rx_dma_isr();
+    }
+    if (dma_interrupt_flag_get(DMA_CH4, DMA_INT_FLAG_FTF))
+    {
+        dma_interrupt_flag_clear(DMA_CH4, DMA_INT_FLAG_FTF);
+        uart_rx_dma_isr();
+    }
+#endif
+}
+#endif
+
+#if USART_RX_DMA
+// ߿һַʱ䣺һ꣬Ȱͽѭ
+void USART0_IRQHandler(void)
+{
+    if (usart_interrupt_flag_get(USART0, USART_INT_FLAG_IDLE))
+    {
+        usart_interrupt_flag_clear(USART0, USART_INT_FLAG_IDLE);
+        uart_rx_dma_isr();
+    }
+}
+#endif
+
+#if WS2812_USART_BACKEND
+
+// ݶһֽƳеλ
+void USART1_IRQHandler(void)
+{
+    if (usart_interrupt_flag_get(USART1, USART_INT_FLAG_TC))
+    {
+        usart_interrupt_flag_clear(USART1, USART_INT_FLAG_TC);
+        HAL_WS2812_UsartIdle();
     }
 }
+#endif
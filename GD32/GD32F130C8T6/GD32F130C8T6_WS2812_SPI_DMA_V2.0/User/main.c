@@ -7,17 +7,50 @@
 #include "led.h"
 #include "ws2812_driver.h"
 #include "hal_ws2812.h"
+#include "ws2812_config.h"
 #include "usart.h"
+#include "scheduler.h"
+#include "ws2812_pacer.h"
+#include "ws2812_host.h"
+
+// 板载指示灯心跳
+static uint32_t heartbeat_step(uint32_t now_ms)
+{
+    led_toggle();
+    return 500;
+}
 
 int main(void)
 {
+#if (WS2812_LANES > 1)
+    WS2812_StripConfig strip[WS2812_LANES];
+
+    for (uint8_t i = 0; i < WS2812_LANES; i++)
+        strip[i] = (WS2812_StripConfig){WS2812_LANE_LED_POOL, WS2812_PROTOCOL, WS2812_COLOR_ORDER, WS2812_BACKEND_TIMER};
+#else
+    WS2812_StripConfig strip[1] = {{WS2812_LoadLedCount(), WS2812_PROTOCOL, WS2812_COLOR_ORDER, WS2812_BACKEND}};
+#endif
+
     systick_config();
     led_gpio_init();
+#if WS2812_HOST_LINK
+    uart_init(WS2812_HOST_BAUD);
+#else
     uart_init(115200);
-    HAL_WS2812_Init();
-    while (1)
-    {
-        WS2812_LIUSHUI();
-        led_toggle();
-    }
+#endif
+    HAL_WS2812_Init(strip);
+#if (WS2812_EFFECT == WS2812_EFFECT_LIUSHUI)
+    scheduler_add("liushui", WS2812_LiushuiStep);
+#elif (WS2812_EFFECT == WS2812_EFFECT_COLOR_CYCLE)
+    scheduler_add("colorcycle", WS2812_ColorCycleStep);
+#else
+    WS2812_PacerInit(WS2812_PACER_FPS, WS2812_RainbowRender);
+    scheduler_add("pacer", WS2812_PacerStep);
+#endif
+#if WS2812_HOST_LINK
+    WS2812_HostInit();
+    scheduler_add("host", WS2812_HostStep);
+#endif
+    scheduler_add("heartbeat", heartbeat_step);
+    scheduler_run();
 }
@@ -36,6 +36,7 @@ OF SUCH DAMAGE.
 #include "systick.h"
 
 volatile static uint32_t delay;
+volatile static uint32_t tick_ms;
 
 /*!
     \brief      configure systick
@@ -80,4 +81,40 @@ void delay_decrement(void)
     if(0U != delay){
         delay--;
     }
+    tick_ms++;
+}
+
+/*!
+    \brief      get the milliseconds elapsed since systick_config()
+    \param[in]  none
+    \param[out] none
+    \retval     tick count in milliseconds, wraps around after about 49 days
+*/
+uint32_t systick_ms_get(void)
+{
+    return tick_ms;
+}
+
+/*!
+    \brief      enable the DWT cycle counter
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void cycle_counter_init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0U;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/*!
+    \brief      read the DWT cycle counter
+    \param[in]  none
+    \param[out] none
+    \retval     core clock cycles since cycle_counter_init(), wraps around
+*/
+uint32_t cycle_counter_get(void)
+{
+    return DWT->CYCCNT;
 }
@@ -44,5 +44,11 @@ void systick_config(void);
 void delay_1ms(uint32_t count);
 /* delay decrement */
 void delay_decrement(void);
+/* get the milliseconds elapsed since systick_config() */
+uint32_t systick_ms_get(void);
+/* enable the DWT cycle counter */
+void cycle_counter_init(void);
+/* read the DWT cycle counter */
+uint32_t cycle_counter_get(void);
 
 #endif /* SYSTICK_H */